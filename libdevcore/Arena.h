@@ -0,0 +1,129 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Arena.h
+ * @date 2018
+ *
+ * Bump allocator for objects that are released together.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dev
+{
+
+/**
+ * Bump allocator for objects of type T that are all destroyed together.
+ * Objects are placed consecutively into chunks of memory which are kept by reset(), so an
+ * arena that is reused does not allocate anymore once it has grown to its working size.
+ * Pointers to the objects stay valid until reset() is called or the arena is destroyed.
+ */
+template <class T>
+class Arena: boost::noncopyable
+{
+public:
+	explicit Arena(size_t _chunkSize = 1024): m_chunkSize(_chunkSize) {}
+	~Arena() { reset(); }
+
+	/// Constructs a new object from @a _args.
+	/// @returns a pointer to the new object.
+	template <class... Args>
+	T* emplace(Args&&... _args)
+	{
+		T* object = new (reserve(1)) T(std::forward<Args>(_args)...);
+		m_chunks[m_current].used++;
+		return object;
+	}
+
+	/// Copies the elements of [_begin, _end) into consecutive memory.
+	/// @returns a pointer to the first copy or nullptr if the range is empty.
+	template <class Iterator>
+	T* append(Iterator _begin, Iterator _end)
+	{
+		size_t count = std::distance(_begin, _end);
+		if (count == 0)
+			return nullptr;
+		T* objects = reserve(count);
+		std::uninitialized_copy(_begin, _end, objects);
+		m_chunks[m_current].used += count;
+		return objects;
+	}
+
+	/// @returns uninitialised memory for @a _count consecutive objects. Only available for
+	/// trivially destructible types since reset() does not know which objects were constructed.
+	T* allocate(size_t _count)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "Only trivially destructible objects can be allocated.");
+		T* objects = reserve(_count);
+		m_chunks[m_current].used += _count;
+		return objects;
+	}
+
+	/// Destroys all objects but keeps the memory for reuse.
+	void reset()
+	{
+		for (Chunk& chunk: m_chunks)
+		{
+			if (!std::is_trivially_destructible<T>::value)
+				for (size_t i = 0; i < chunk.used; ++i)
+					reinterpret_cast<T*>(&chunk.memory[i])->~T();
+			chunk.used = 0;
+		}
+		m_current = 0;
+	}
+
+private:
+	using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+	struct Chunk
+	{
+		std::unique_ptr<Storage[]> memory;
+		size_t size;
+		size_t used;
+	};
+
+	/// @returns uninitialised memory for @a _count consecutive objects, moving on to the next
+	/// chunk with enough space or allocating a new one if needed.
+	T* reserve(size_t _count)
+	{
+		while (m_current < m_chunks.size() && m_chunks[m_current].size - m_chunks[m_current].used < _count)
+			m_current++;
+		if (m_current == m_chunks.size())
+		{
+			size_t size = std::max(m_chunkSize, _count);
+			m_chunks.push_back(Chunk{std::unique_ptr<Storage[]>(new Storage[size]), size, 0});
+		}
+		Chunk& chunk = m_chunks[m_current];
+		return reinterpret_cast<T*>(&chunk.memory[chunk.used]);
+	}
+
+	size_t m_chunkSize;
+	std::vector<Chunk> m_chunks;
+	/// Index of the chunk new objects are placed into.
+	size_t m_current = 0;
+};
+
+}
@@ -0,0 +1,74 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file CopyOnWrite.h
+ * @date 2018
+ *
+ * Value that is shared between copies until one of them is modified.
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace dev
+{
+
+/**
+ * Holds a value of type T that is shared between copies of the holder until one of them is
+ * modified, so copying is cheap even for large containers.
+ * Copies must not be used concurrently from different threads.
+ */
+template <class T>
+class CopyOnWrite
+{
+public:
+	CopyOnWrite() = default;
+	CopyOnWrite(T _value): m_value(std::make_shared<T>(std::move(_value))) {}
+
+	T const& operator*() const { return m_value ? *m_value : empty(); }
+	T const* operator->() const { return &**this; }
+
+	/// @returns a reference to the value that can be modified, copying it first if it
+	/// is shared with other holders.
+	T& mutate()
+	{
+		if (!m_value)
+			m_value = std::make_shared<T>();
+		else if (m_value.use_count() > 1)
+			m_value = std::make_shared<T>(*m_value);
+		return *m_value;
+	}
+
+	/// Replaces the value by a default-constructed one.
+	void reset() { m_value.reset(); }
+
+	/// @returns true if both holders are known to hold the same value because they share it.
+	bool sharesWith(CopyOnWrite const& _other) const { return m_value == _other.m_value; }
+
+private:
+	static T const& empty()
+	{
+		static T const value{};
+		return value;
+	}
+
+	/// The value, nullptr if it is default-constructed.
+	std::shared_ptr<T> m_value;
+};
+
+}
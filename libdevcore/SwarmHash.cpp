@@ -40,12 +40,12 @@ h256 swarmHashSimple(bytesConstRef _data, size_t _size)
 	return keccak256(toLittleEndian(_size) + _data.toBytes());
 }
 
-h256 swarmHashIntermediate(string const& _input, size_t _offset, size_t _length)
+h256 swarmHashIntermediate(bytesConstRef _input, size_t _offset, size_t _length)
 {
 	bytesConstRef ref;
 	bytes innerNodes;
 	if (_length <= 0x1000)
-		ref = bytesConstRef(_input).cropped(_offset, _length);
+		ref = _input.cropped(_offset, _length);
 	else
 	{
 		size_t maxRepresentedSize = 0x1000;
@@ -63,7 +63,7 @@ h256 swarmHashIntermediate(string const& _input, size_t _offset, size_t _length)
 
 }
 
-h256 dev::swarmHash(string const& _input)
+h256 dev::swarmHash(bytesConstRef _input)
 {
 	return swarmHashIntermediate(_input, 0, _input.size());
 }
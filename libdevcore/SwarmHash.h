@@ -27,6 +27,6 @@ namespace dev
 {
 
 /// Compute the "swarm hash" of @a _input
-h256 swarmHash(std::string const& _input);
+h256 swarmHash(bytesConstRef _input);
 
 }
@@ -0,0 +1,147 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Timings.cpp
+ * @date 2018
+ */
+
+#include <libdevcore/Timings.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// @returns the peak resident set size of the process in bytes or zero if unknown.
+size_t peakMemoryUsage()
+{
+#if defined(__linux__) || defined(__APPLE__)
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#if defined(__APPLE__)
+	return size_t(usage.ru_maxrss);
+#else
+	return size_t(usage.ru_maxrss) * 1024;
+#endif
+#else
+	return 0;
+#endif
+}
+
+}
+
+Timings::Scope::Scope(Timings* _timings, string const& _unit)
+{
+	if (!_timings)
+		return;
+	m_active = true;
+	m_previousTimings = current();
+	m_previousUnit = move(currentUnit());
+	current() = _timings;
+	currentUnit() = _unit;
+}
+
+Timings::Scope::~Scope()
+{
+	if (!m_active)
+		return;
+	current() = m_previousTimings;
+	currentUnit() = move(m_previousUnit);
+}
+
+Timings::Timer::Timer(char const* _phase):
+	m_phase(_phase),
+	m_timings(current())
+{
+	if (!m_timings)
+		return;
+	m_peakMemory = peakMemoryUsage();
+	m_start = chrono::steady_clock::now();
+}
+
+Timings::Timer::~Timer()
+{
+	if (!m_timings)
+		return;
+	chrono::duration<double> duration = chrono::steady_clock::now() - m_start;
+	size_t peakMemory = peakMemoryUsage();
+	m_timings->record(
+		currentUnit(),
+		m_phase,
+		duration.count(),
+		peakMemory > m_peakMemory ? peakMemory - m_peakMemory : 0
+	);
+}
+
+function<void()> Timings::inCurrentScope(function<void()> _function)
+{
+	Timings* timings = current();
+	if (!timings)
+		return _function;
+	string unit = currentUnit();
+	return [=]()
+	{
+		Scope scope(timings, unit);
+		_function();
+	};
+}
+
+Timings::Measurements Timings::measurements() const
+{
+	lock_guard<mutex> lock(m_mutex);
+	return m_measurements;
+}
+
+Json::Value Timings::toJson() const
+{
+	Json::Value output(Json::objectValue);
+	for (auto const& unit: measurements())
+		for (auto const& phase: unit.second)
+		{
+			Json::Value& measurement = output[unit.first][phase.first];
+			measurement["seconds"] = phase.second.seconds;
+			measurement["count"] = Json::UInt64(phase.second.count);
+			measurement["peakMemoryIncrease"] = Json::UInt64(phase.second.peakMemoryIncrease);
+		}
+	return output;
+}
+
+void Timings::record(string const& _unit, string const& _phase, double _seconds, size_t _peakMemoryIncrease)
+{
+	lock_guard<mutex> lock(m_mutex);
+	Measurement& measurement = m_measurements[_unit][_phase];
+	measurement.seconds += _seconds;
+	measurement.count++;
+	measurement.peakMemoryIncrease += _peakMemoryIncrease;
+}
+
+Timings*& Timings::current()
+{
+	static thread_local Timings* timings = nullptr;
+	return timings;
+}
+
+string& Timings::currentUnit()
+{
+	static thread_local string unit;
+	return unit;
+}
@@ -0,0 +1,104 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Timings.h
+ * @date 2018
+ *
+ * Measurement of the time spent in the phases of a compilation.
+ */
+
+#pragma once
+
+#include <json/json.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace dev
+{
+
+/**
+ * Collects the time spent in the phases of a compilation and the growth of the peak memory
+ * usage of the process during them, per unit (e.g. source or contract) and phase.
+ * Phases are measured by Timer objects, which only measure anything while a Scope is active
+ * on the current thread, so they can be placed anywhere at almost no cost.
+ * Measurements of nested phases are included in the enclosing ones.
+ */
+class Timings: boost::noncopyable
+{
+public:
+	struct Measurement
+	{
+		double seconds = 0;
+		/// Number of times the phase was run.
+		size_t count = 0;
+		/// Sum of the increases of the peak resident set size of the process in bytes.
+		/// Zero if it cannot be determined on this platform.
+		size_t peakMemoryIncrease = 0;
+	};
+	/// Measurements by unit and phase.
+	using Measurements = std::map<std::string, std::map<std::string, Measurement>>;
+
+	/// While it exists, the measurements taken on the current thread are added to @a _timings
+	/// and attributed to @a _unit. Does nothing if @a _timings is null.
+	class Scope: boost::noncopyable
+	{
+	public:
+		Scope(Timings* _timings, std::string const& _unit);
+		~Scope();
+	private:
+		bool m_active = false;
+		Timings* m_previousTimings = nullptr;
+		std::string m_previousUnit;
+	};
+
+	/// Measures the phase @a _phase from construction until destruction.
+	class Timer: boost::noncopyable
+	{
+	public:
+		explicit Timer(char const* _phase);
+		~Timer();
+	private:
+		char const* m_phase;
+		Timings* m_timings;
+		std::chrono::steady_clock::time_point m_start;
+		size_t m_peakMemory = 0;
+	};
+
+	/// @returns a function that runs @a _function such that its measurements are taken in the
+	/// scope that is active on the current thread, for use on other threads.
+	static std::function<void()> inCurrentScope(std::function<void()> _function);
+
+	Measurements measurements() const;
+	/// @returns the measurements as a JSON object of units containing objects of phases.
+	Json::Value toJson() const;
+
+private:
+	void record(std::string const& _unit, std::string const& _phase, double _seconds, size_t _peakMemoryIncrease);
+
+	static Timings*& current();
+	static std::string& currentUnit();
+
+	mutable std::mutex m_mutex;
+	Measurements m_measurements;
+};
+
+}
@@ -28,14 +28,41 @@
 #include <libevmasm/BlockDeduplicator.h>
 #include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/GasMeter.h>
+#include <libevmasm/SemanticInformation.h>
 
+#include <libdevcore/Timings.h>
+
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <limits>
+#include <thread>
+#include <unordered_map>
 #include <json/json.h>
 
 using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
+namespace
+{
+
+/// @returns a hash of the items in [@a _begin, @a _end) that is equal for equal items.
+size_t itemsHash(AssemblyItems::const_iterator _begin, AssemblyItems::const_iterator _end)
+{
+	size_t hash = 0;
+	for (auto it = _begin; it != _end; ++it)
+	{
+		size_t itemHash = it->type() == Operation ?
+			size_t(it->instruction()) :
+			size_t(it->data() & u256(numeric_limits<size_t>::max()));
+		hash = hash * 31 + (itemHash ^ (size_t(it->type()) << 8));
+	}
+	return hash;
+}
+
+}
+
 void Assembly::append(Assembly const& _a)
 {
 	auto newDeposit = m_deposit + _a.deposit();
@@ -89,10 +116,10 @@ namespace
 
 string locationFromSources(StringMap const& _sourceCodes, SourceLocation const& _location)
 {
-	if (_location.isEmpty() || _sourceCodes.empty() || _location.start >= _location.end || _location.start < 0)
+	if (_location.isEmpty() || !_location.sourceName() || _sourceCodes.empty() || _location.start >= _location.end || _location.start < 0)
 		return "";
 
-	auto it = _sourceCodes.find(*_location.sourceName);
+	auto it = _sourceCodes.find(*_location.sourceName());
 	if (it == _sourceCodes.end())
 		return "";
 
@@ -161,11 +188,11 @@ public:
 
 	void printLocation()
 	{
-		if (!m_location.sourceName && m_location.isEmpty())
+		if (!m_location.sourceName() && m_location.isEmpty())
 			return;
 		m_out << m_prefix << "    /*";
-		if (m_location.sourceName)
-			m_out << " \"" + *m_location.sourceName + "\"";
+		if (m_location.sourceName())
+			m_out << " \"" + *m_location.sourceName() + "\"";
 		if (!m_location.isEmpty())
 			m_out << ":" << to_string(m_location.start) + ":" + to_string(m_location.end);
 		m_out << "  " << locationFromSources(m_sourceCodes, m_location);
@@ -348,12 +375,20 @@ AssemblyItem Assembly::newPushLibraryAddress(string const& _identifier)
 	return AssemblyItem(PushLibraryAddress, h);
 }
 
+AssemblyPointer Assembly::deepCopy() const
+{
+	AssemblyPointer copy = make_shared<Assembly>(*this);
+	for (auto& sub: copy->m_subs)
+		sub = sub->deepCopy();
+	return copy;
+}
+
 void Assembly::injectStart(AssemblyItem const& _i)
 {
 	m_items.insert(m_items.begin(), _i);
 }
 
-Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation, size_t _runs)
+Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation, size_t _runs, unsigned _threads)
 {
 	OptimiserSettings settings;
 	settings.isCreation = _isCreation;
@@ -367,6 +402,7 @@ Assembly& Assembly::optimise(bool _enable, EVMVersion _evmVersion, bool _isCreat
 	}
 	settings.evmVersion = _evmVersion;
 	settings.expectedExecutionsPerDeployment = _runs;
+	settings.threads = max(_threads, 1u);
 	optimise(settings);
 	return *this;
 }
@@ -383,70 +419,157 @@ map<u256, u256> Assembly::optimiseInternal(
 	std::set<size_t> const& _tagsReferencedFromOutside
 )
 {
-	// Run optimisation for sub-assemblies.
+	// Run optimisation for sub-assemblies. They do not depend on each other, so they are
+	// optimised concurrently unless the same sub-assembly is referenced more than once.
+	set<Assembly const*> distinctSubs;
+	for (auto const& sub: m_subs)
+		distinctSubs.insert(sub.get());
+	unsigned workerCount = distinctSubs.size() == m_subs.size() ? unsigned(min<size_t>(_settings.threads, m_subs.size())) : 1;
+
+	OptimiserSettings settings = _settings;
+	// Disable creation mode for sub-assemblies.
+	settings.isCreation = false;
+	// Distribute the threads among the sub-assemblies optimised at the same time.
+	settings.threads = max(_settings.threads / max(workerCount, 1u), 1u);
+	vector<set<size_t>> referencedTags;
 	for (size_t subId = 0; subId < m_subs.size(); ++subId)
+		referencedTags.push_back(JumpdestRemover::referencedTags(m_items, subId));
+	vector<map<u256, u256>> subTagReplacements(m_subs.size());
+	vector<exception_ptr> failures(m_subs.size());
+	atomic<size_t> nextSub{0};
+	auto worker = [&]()
 	{
-		OptimiserSettings settings = _settings;
-		// Disable creation mode for sub-assemblies.
-		settings.isCreation = false;
-		map<u256, u256> subTagReplacements = m_subs[subId]->optimiseInternal(
-			settings,
-			JumpdestRemover::referencedTags(m_items, subId)
-		);
-		// Apply the replacements (can be empty).
-		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements, subId);
+		for (size_t subId = nextSub++; subId < m_subs.size(); subId = nextSub++)
+			try
+			{
+				subTagReplacements[subId] = m_subs[subId]->optimiseInternal(settings, referencedTags[subId]);
+			}
+			catch (...)
+			{
+				failures[subId] = current_exception();
+			}
+	};
+	if (workerCount > 1)
+	{
+		vector<thread> workers;
+		for (unsigned i = 0; i < workerCount; ++i)
+			workers.emplace_back(Timings::inCurrentScope(worker));
+		for (thread& w: workers)
+			w.join();
+	}
+	else
+		worker();
+
+	// Apply the replacements (can be empty) in the same order as a serial optimisation.
+	for (size_t subId = 0; subId < m_subs.size(); ++subId)
+	{
+		if (failures[subId])
+			rethrow_exception(failures[subId]);
+		BlockDeduplicator::applyTagReplacement(m_items, subTagReplacements[subId], subId);
 	}
 
 	map<u256, u256> tagReplacements;
+	// Blocks the common subexpression eliminator did not change, by their hash. The other
+	// passes do not tell where they modify the items, so a block is recognised as unmodified
+	// if its content is the same.
+	unordered_multimap<size_t, AssemblyItems> unchangedCSEBlocks;
+	bool unchangedCSEBlocksUseMSize = false;
+	unsigned iteration = 0;
+
+	// Runs @a _pass, which returns whether it changed anything, and reports its statistics.
+	auto runPass = [&](char const* _name, function<bool(OptimiserPassStatistics&)> const& _pass)
+	{
+		Timings::Timer timer(_name);
+		OptimiserPassStatistics statistics;
+		statistics.pass = _name;
+		statistics.iteration = iteration;
+		statistics.itemsBefore = m_items.size();
+		statistics.changed = _pass(statistics);
+		statistics.itemsAfter = m_items.size();
+		if (_settings.statistics)
+			_settings.statistics(statistics);
+		return statistics.changed;
+	};
+
 	// Iterate until no new optimisation possibilities are found.
 	for (unsigned count = 1; count > 0;)
 	{
+		Timings::Timer iterationTimer("Optimiser iteration");
 		count = 0;
+		iteration++;
 
-		if (_settings.runJumpdestRemover)
-		{
+		if (_settings.runJumpdestRemover && runPass("JumpdestRemover", [&](OptimiserPassStatistics&) {
 			JumpdestRemover jumpdestOpt(m_items);
-			if (jumpdestOpt.optimise(_tagsReferencedFromOutside))
-				count++;
-		}
+			return jumpdestOpt.optimise(_tagsReferencedFromOutside);
+		}))
+			count++;
 
-		if (_settings.runPeephole)
-		{
+		if (_settings.runPeephole && runPass("PeepholeOptimiser", [&](OptimiserPassStatistics&) {
 			PeepholeOptimiser peepOpt(m_items);
+			// A single run reaches a fixpoint, the loop only guards against rules that undo
+			// each other.
+			unsigned runs = 0;
 			while (peepOpt.optimise())
-			{
-				count++;
-				assertThrow(count < 64000, OptimizerException, "Peephole optimizer seems to be stuck.");
-			}
-		}
+				assertThrow(++runs < 64000, OptimizerException, "Peephole optimizer seems to be stuck.");
+			return runs > 0;
+		}))
+			count++;
 
 		// This only modifies PushTags, we have to run again to actually remove code.
-		if (_settings.runDeduplicate)
-		{
+		if (_settings.runDeduplicate && runPass("BlockDeduplicator", [&](OptimiserPassStatistics&) {
 			BlockDeduplicator dedup(m_items);
-			if (dedup.deduplicate())
-			{
-				tagReplacements.insert(dedup.replacedTags().begin(), dedup.replacedTags().end());
-				count++;
-			}
-		}
-
-		if (_settings.runCSE)
-		{
+			if (!dedup.deduplicate())
+				return false;
+			tagReplacements.insert(dedup.replacedTags().begin(), dedup.replacedTags().end());
+			return true;
+		}))
+			count++;
+
+		if (_settings.runCSE && runPass("CommonSubexpressionEliminator", [&](OptimiserPassStatistics& _statistics) {
 			// Control flow graph optimization has been here before but is disabled because it
 			// assumes we only jump to tags that are pushed. This is not the case anymore with
 			// function types that can be stored in storage.
 			AssemblyItems optimisedItems;
 
 			bool usesMSize = (find(m_items.begin(), m_items.end(), AssemblyItem(Instruction::MSIZE)) != m_items.end());
+			if (usesMSize != unchangedCSEBlocksUseMSize)
+			{
+				unchangedCSEBlocks.clear();
+				unchangedCSEBlocksUseMSize = usesMSize;
+			}
 
+			// Only needed for one block at a time, so the memory is reused for the next block.
+			auto expressionClasses = make_shared<ExpressionClasses>();
 			auto iter = m_items.begin();
 			while (iter != m_items.end())
 			{
-				KnownState emptyState;
-				CommonSubexpressionEliminator eliminator(emptyState);
 				auto orig = iter;
+				auto blockEnd = find_if(iter, m_items.end(), [&](AssemblyItem const& _item) {
+					return SemanticInformation::breaksCSEAnalysisBlock(_item, usesMSize);
+				});
+				if (blockEnd != m_items.end())
+					++blockEnd;
+				_statistics.blocks++;
+
+				size_t hash = itemsHash(orig, blockEnd);
+				auto unchanged = unchangedCSEBlocks.equal_range(hash);
+				if (any_of(unchanged.first, unchanged.second, [&](pair<size_t const, AssemblyItems> const& _block) {
+					return
+						_block.second.size() == size_t(blockEnd - orig) &&
+						equal(orig, blockEnd, _block.second.begin());
+				}))
+				{
+					_statistics.skippedBlocks++;
+					copy(orig, blockEnd, back_inserter(optimisedItems));
+					iter = blockEnd;
+					continue;
+				}
+
+				expressionClasses->reset();
+				KnownState emptyState(expressionClasses);
+				CommonSubexpressionEliminator eliminator(emptyState);
 				iter = eliminator.feedItems(iter, m_items.end(), usesMSize);
+				assertThrow(iter == blockEnd, OptimizerException, "Unexpected end of block.");
 				bool shouldReplace = false;
 				AssemblyItems optimisedChunk;
 				try
@@ -466,22 +589,26 @@ map<u256, u256> Assembly::optimiseInternal(
 				}
 
 				if (shouldReplace)
-				{
-					count++;
 					optimisedItems += optimisedChunk;
-				}
 				else
+				{
 					copy(orig, iter, back_inserter(optimisedItems));
+					unchangedCSEBlocks.emplace(hash, AssemblyItems(orig, iter));
+				}
 			}
 			if (optimisedItems.size() < m_items.size())
 			{
 				m_items = move(optimisedItems);
-				count++;
+				return true;
 			}
-		}
+			return false;
+		}))
+			count++;
 	}
 
 	if (_settings.runConstantOptimiser)
+	{
+		Timings::Timer timer("ConstantOptimiser");
 		ConstantOptimisationMethod::optimiseConstants(
 			_settings.isCreation,
 			_settings.isCreation ? 1 : _settings.expectedExecutionsPerDeployment,
@@ -489,6 +616,7 @@ map<u256, u256> Assembly::optimiseInternal(
 			*this,
 			m_items
 		);
+	}
 
 	return tagReplacements;
 }
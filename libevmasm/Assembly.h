@@ -31,6 +31,7 @@
 
 #include <json/json.h>
 
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <memory>
@@ -99,8 +100,29 @@ public:
 
 	/// Assembles the assembly into bytecode. The assembly should not be modified after this call.
 	LinkerObject const& assemble() const;
+	/// @returns a copy of this assembly that does not share any sub-assemblies with it,
+	/// so that it can be modified (e.g. optimised) independently.
+	AssemblyPointer deepCopy() const;
 	bytes const& data(h256 const& _i) const { return m_data.at(_i); }
 
+	/// Statistics about a run of an optimiser pass on the items of an assembly.
+	struct OptimiserPassStatistics
+	{
+		/// Name of the pass.
+		std::string pass;
+		/// Iteration of the optimiser loop, starting at one.
+		unsigned iteration = 0;
+		size_t itemsBefore = 0;
+		size_t itemsAfter = 0;
+		/// Number of blocks the pass works on separately, zero for passes on the whole assembly.
+		size_t blocks = 0;
+		/// Number of blocks that were skipped because the pass left them unmodified in an
+		/// earlier iteration and no other pass changed them since.
+		size_t skippedBlocks = 0;
+		/// Whether the pass changed anything.
+		bool changed = false;
+	};
+
 	struct OptimiserSettings
 	{
 		bool isCreation = false;
@@ -113,6 +135,11 @@ public:
 		/// This specifies an estimate on how often each opcode in this assembly will be executed,
 		/// i.e. use a small value to optimise for size and a large value to optimise for runtime gas usage.
 		size_t expectedExecutionsPerDeployment = 200;
+		/// Maximum number of threads used to optimise independent sub-assemblies concurrently.
+		unsigned threads = 1;
+		/// If set, called after every run of a pass. It is called concurrently for
+		/// sub-assemblies that are optimised in parallel.
+		std::function<void(OptimiserPassStatistics const&)> statistics;
 	};
 
 	/// Execute optimisation passes as defined by @a _settings and return the optimised assembly.
@@ -123,7 +150,8 @@ public:
 	/// @a _runs specifes an estimate on how often each opcode in this assembly will be executed,
 	/// i.e. use a small value to optimise for size and a large value to optimise for runtime.
 	/// If @a _enable is not set, will perform some simple peephole optimizations.
-	Assembly& optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation = true, size_t _runs = 200);
+	/// Sub-assemblies are optimised on up to @a _threads threads.
+	Assembly& optimise(bool _enable, EVMVersion _evmVersion, bool _isCreation = true, size_t _runs = 200, unsigned _threads = 1);
 
 	/// Create a text representation of the assembly.
 	std::string assemblyString(
@@ -28,7 +28,7 @@ using namespace dev::eth;
 
 AssemblyItem AssemblyItem::toSubAssemblyTag(size_t _subId) const
 {
-	assertThrow(data() < (u256(1) << 64), Exception, "Tag already has subassembly set.");
+	assertThrow(!m_largeData, Exception, "Tag already has subassembly set.");
 
 	assertThrow(m_type == PushTag || m_type == Tag, Exception, "");
 	AssemblyItem r = *this;
@@ -40,6 +40,8 @@ AssemblyItem AssemblyItem::toSubAssemblyTag(size_t _subId) const
 pair<size_t, size_t> AssemblyItem::splitForeignPushTag() const
 {
 	assertThrow(m_type == PushTag || m_type == Tag, Exception, "");
+	if (!m_largeData)
+		return make_pair(size_t(-1), size_t(m_smallData));
 	return make_pair(size_t((data()) / (u256(1) << 64)) - 1, size_t(data()));
 }
 
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <boost/optional.hpp>
 #include <libdevcore/Common.h>
 #include <libdevcore/Assertions.h>
 #include <libevmasm/Instruction.h>
@@ -35,7 +36,7 @@ namespace dev
 namespace eth
 {
 
-enum AssemblyItemType {
+enum AssemblyItemType: uint8_t {
 	UndefinedItem,
 	Operation,
 	Push,
@@ -55,7 +56,7 @@ class Assembly;
 class AssemblyItem
 {
 public:
-	enum class JumpType { Ordinary, IntoFunction, OutOfFunction };
+	enum class JumpType: uint8_t { Ordinary, IntoFunction, OutOfFunction };
 
 	AssemblyItem(u256 _push, SourceLocation const& _location = SourceLocation()):
 		AssemblyItem(Push, _push, _location) { }
@@ -71,7 +72,7 @@ public:
 		if (m_type == Operation)
 			m_instruction = Instruction(byte(_data));
 		else
-			m_data = std::make_shared<u256>(_data);
+			setData(_data);
 	}
 
 	AssemblyItem tag() const { assertThrow(m_type == PushTag || m_type == Tag, Exception, ""); return AssemblyItem(Tag, data()); }
@@ -86,8 +87,21 @@ public:
 	void setPushTagSubIdAndTag(size_t _subId, size_t _tag);
 
 	AssemblyItemType type() const { return m_type; }
-	u256 const& data() const { assertThrow(m_type != Operation, Exception, ""); return *m_data; }
-	void setData(u256 const& _data) { assertThrow(m_type != Operation, Exception, ""); m_data = std::make_shared<u256>(_data); }
+	u256 data() const { assertThrow(m_type != Operation, Exception, ""); return m_largeData ? *m_largeData : u256(m_smallData); }
+	void setData(u256 const& _data)
+	{
+		assertThrow(m_type != Operation, Exception, "");
+		if (_data <= std::numeric_limits<uint64_t>::max())
+		{
+			m_smallData = uint64_t(_data);
+			m_largeData.reset();
+		}
+		else
+		{
+			m_smallData = 0;
+			m_largeData = std::make_shared<u256 const>(_data);
+		}
+	}
 
 	/// @returns the instruction of this item (only valid if type() == Operation)
 	Instruction instruction() const { assertThrow(m_type == Operation, Exception, ""); return m_instruction; }
@@ -99,8 +113,11 @@ public:
 			return false;
 		if (type() == Operation)
 			return instruction() == _other.instruction();
+		else if (!m_largeData || !_other.m_largeData)
+			// Data is only stored in m_largeData if it does not fit into m_smallData.
+			return !m_largeData && !_other.m_largeData && m_smallData == _other.m_smallData;
 		else
-			return data() == _other.data();
+			return *m_largeData == *_other.m_largeData;
 	}
 	bool operator!=(AssemblyItem const& _other) const { return !operator==(_other); }
 	/// Less-than operator compatible with operator==.
@@ -110,8 +127,10 @@ public:
 			return type() < _other.type();
 		else if (type() == Operation)
 			return instruction() < _other.instruction();
+		else if (!m_largeData || !_other.m_largeData)
+			return m_largeData ? false : (_other.m_largeData || m_smallData < _other.m_smallData);
 		else
-			return data() < _other.data();
+			return *m_largeData < *_other.m_largeData;
 	}
 
 	/// @returns an upper bound for the number of bytes required by this item, assuming that
@@ -131,20 +150,34 @@ public:
 	JumpType getJumpType() const { return m_jumpType; }
 	std::string getJumpTypeAsString() const;
 
-	void setPushedValue(u256 const& _value) const { m_pushedValue = std::make_shared<u256>(_value); }
-	u256 const* pushedValue() const { return m_pushedValue.get(); }
+	/// Sets the value pushed by a PushSubSize item, which is only known during assembly.
+	void setPushedValue(u256 const& _value) const
+	{
+		assertThrow(_value <= std::numeric_limits<uint64_t>::max(), Exception, "Pushed value too large.");
+		m_pushedValue = uint64_t(_value);
+		m_hasPushedValue = true;
+	}
+	boost::optional<u256> pushedValue() const
+	{
+		return m_hasPushedValue ? boost::optional<u256>(m_pushedValue) : boost::none;
+	}
 
 	std::string toAssemblyText() const;
 
 private:
 	AssemblyItemType m_type;
 	Instruction m_instruction; ///< Only valid if m_type == Operation
-	std::shared_ptr<u256> m_data; ///< Only valid if m_type != Operation
-	SourceLocation m_location;
 	JumpType m_jumpType = JumpType::Ordinary;
+	mutable bool m_hasPushedValue = false;
+	/// Data of items other than operations, if it fits into 64 bits. This is the case for almost all
+	/// items, so copying them does not require any allocation or reference counting.
+	uint64_t m_smallData = 0;
+	/// Data that does not fit into m_smallData (e.g. hashes and foreign push tags), shared among copies.
+	std::shared_ptr<u256 const> m_largeData;
 	/// Pushed value for operations with data to be determined during assembly stage,
-	/// e.g. PushSubSize, PushTag, PushSub, etc.
-	mutable std::shared_ptr<u256> m_pushedValue;
+	/// e.g. PushSubSize, PushTag, PushSub, etc. Only valid if m_hasPushedValue is set.
+	mutable uint64_t m_pushedValue = 0;
+	SourceLocation m_location;
 };
 
 using AssemblyItems = std::vector<AssemblyItem>;
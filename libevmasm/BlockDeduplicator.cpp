@@ -27,7 +27,8 @@
 #include <libevmasm/SemanticInformation.h>
 
 #include <functional>
-#include <set>
+#include <limits>
+#include <unordered_map>
 
 using namespace std;
 using namespace dev;
@@ -36,8 +37,8 @@ using namespace dev::eth;
 
 bool BlockDeduplicator::deduplicate()
 {
-	// Compares indices based on the suffix that starts there, ignoring tags and stopping at
-	// opcodes that stop the control flow.
+	// Blocks are compared based on the suffix that starts at their tag, ignoring tags and
+	// stopping at opcodes that stop the control flow.
 
 	// Virtual tag that signifies "the current block" and which is used to optimise loops.
 	// We abort if this virtual tag actually exists.
@@ -48,49 +49,27 @@ bool BlockDeduplicator::deduplicate()
 	)
 		return false;
 
-	function<bool(size_t, size_t)> comparator = [&](size_t _i, size_t _j)
-	{
-		if (_i == _j)
-			return false;
-
-		// To compare recursive loops, we have to already unify PushTag opcodes of the
-		// block's own tag.
-		AssemblyItem pushFirstTag(pushSelf);
-		AssemblyItem pushSecondTag(pushSelf);
-
-		if (_i < m_items.size() && m_items.at(_i).type() == Tag)
-			pushFirstTag = m_items.at(_i).pushTag();
-		if (_j < m_items.size() && m_items.at(_j).type() == Tag)
-			pushSecondTag = m_items.at(_j).pushTag();
-
-		BlockIterator first(m_items.begin() + _i, m_items.end(), &pushFirstTag, &pushSelf);
-		BlockIterator second(m_items.begin() + _j, m_items.end(), &pushSecondTag, &pushSelf);
-		BlockIterator end(m_items.end(), m_items.end());
-
-		if (first != end && (*first).type() == Tag)
-			++first;
-		if (second != end && (*second).type() == Tag)
-			++second;
-
-		return std::lexicographical_compare(first, end, second, end);
-	};
-
 	size_t iterations = 0;
 	for (; ; ++iterations)
 	{
-		//@todo this should probably be optimized.
-		set<size_t, function<bool(size_t, size_t)>> blocksSeen(comparator);
+		// Indices of the first block with each content, by the hash of the content.
+		// Blocks are only compared item by item if their hashes are equal.
+		unordered_map<size_t, vector<size_t>> blocksSeen;
 		for (size_t i = 0; i < m_items.size(); ++i)
 		{
 			if (m_items.at(i).type() != Tag)
 				continue;
-			auto it = blocksSeen.find(i);
-			if (it == blocksSeen.end())
-				blocksSeen.insert(i);
+			vector<size_t>& candidates = blocksSeen[blockHash(i, pushSelf)];
+			auto it = find_if(candidates.begin(), candidates.end(), [&](size_t _j) {
+				return blocksEqual(i, _j, pushSelf);
+			});
+			if (it == candidates.end())
+				candidates.push_back(i);
 			else
 				m_replacedTags[m_items.at(i).data()] = m_items.at(*it).data();
 		}
 
+		// Replacing tags can make blocks jumping to them equal, so repeat until nothing changes.
 		if (!applyTagReplacement(m_items, m_replacedTags))
 			break;
 	}
@@ -137,6 +116,49 @@ BlockDeduplicator::BlockIterator& BlockDeduplicator::BlockIterator::operator++()
 	return *this;
 }
 
+BlockDeduplicator::BlockIterator BlockDeduplicator::blockBegin(
+	size_t _tagIndex,
+	AssemblyItem const& _pushTag,
+	AssemblyItem const& _pushSelf
+) const
+{
+	// To compare recursive loops, pushes of the block's own tag are replaced by a virtual tag.
+	BlockIterator it(m_items.begin() + _tagIndex, m_items.end(), &_pushTag, &_pushSelf);
+	// Skip the tag itself.
+	return ++it;
+}
+
+size_t BlockDeduplicator::blockHash(size_t _tagIndex, AssemblyItem const& _pushSelf) const
+{
+	AssemblyItem pushTag = m_items.at(_tagIndex).pushTag();
+	BlockIterator end(m_items.end(), m_items.end());
+	size_t hash = 0;
+	for (auto it = blockBegin(_tagIndex, pushTag, _pushSelf); it != end; ++it)
+	{
+		AssemblyItem const& item = *it;
+		size_t itemHash = item.type() == Operation ?
+			size_t(item.instruction()) :
+			size_t(item.data() & u256(numeric_limits<size_t>::max()));
+		hash = hash * 31 + (itemHash ^ (size_t(item.type()) << 8));
+	}
+	return hash;
+}
+
+bool BlockDeduplicator::blocksEqual(size_t _firstTagIndex, size_t _secondTagIndex, AssemblyItem const& _pushSelf) const
+{
+	if (_firstTagIndex == _secondTagIndex)
+		return true;
+	AssemblyItem pushFirstTag = m_items.at(_firstTagIndex).pushTag();
+	AssemblyItem pushSecondTag = m_items.at(_secondTagIndex).pushTag();
+	BlockIterator end(m_items.end(), m_items.end());
+	BlockIterator first = blockBegin(_firstTagIndex, pushFirstTag, _pushSelf);
+	BlockIterator second = blockBegin(_secondTagIndex, pushSecondTag, _pushSelf);
+	for (; first != end && second != end; ++first, ++second)
+		if (*first != *second)
+			return false;
+	return first == end && second == end;
+}
+
 AssemblyItem const& BlockDeduplicator::BlockIterator::operator*() const
 {
 	if (replaceItem && replaceWith && *it == *replaceItem)
@@ -85,6 +85,14 @@ private:
 		AssemblyItem const* replaceWith;
 	};
 
+	/// @returns an iterator to the first item of the block starting at the tag at @a _tagIndex,
+	/// which replaces pushes of that tag (@a _pushTag) by @a _pushSelf.
+	BlockIterator blockBegin(size_t _tagIndex, AssemblyItem const& _pushTag, AssemblyItem const& _pushSelf) const;
+	/// @returns a hash of the block starting at the tag at @a _tagIndex that is equal for equal blocks.
+	size_t blockHash(size_t _tagIndex, AssemblyItem const& _pushSelf) const;
+	/// @returns true if the blocks starting at the tags at the given indices are equal.
+	bool blocksEqual(size_t _firstTagIndex, size_t _secondTagIndex, AssemblyItem const& _pushSelf) const;
+
 	std::map<u256, u256> m_replacedTags;
 	AssemblyItems& m_items;
 };
@@ -22,7 +22,6 @@
  */
 
 #include <functional>
-#include <boost/range/adaptor/reversed.hpp>
 #include <libdevcore/SHA3.h>
 #include <libevmasm/CommonSubexpressionEliminator.h>
 #include <libevmasm/AssemblyItem.h>
@@ -243,7 +242,7 @@ void CSECodeGenerator::addDependencies(Id _c)
 		// they are different that occur before this load
 		StoreOperation::Target target = expr.item->instruction() == Instruction::SLOAD ?
 			StoreOperation::Storage : StoreOperation::Memory;
-		Id slotToLoadFrom = expr.arguments.at(0);
+		Id slotToLoadFrom = expr.arguments[0];
 		for (auto const& p: m_storeOperations)
 		{
 			if (p.first.first != target)
@@ -263,11 +262,11 @@ void CSECodeGenerator::addDependencies(Id _c)
 				break;
 			case Instruction::KECCAK256:
 			{
-				Id length = expr.arguments.at(1);
+				Id length = expr.arguments[1];
 				AssemblyItem offsetInstr(Instruction::SUB, expr.item->location());
 				Id offsetToStart = m_expressionClasses.find(offsetInstr, {slot, slotToLoadFrom});
-				u256 const* o = m_expressionClasses.knownConstant(offsetToStart);
-				u256 const* l = m_expressionClasses.knownConstant(length);
+				boost::optional<u256> o = m_expressionClasses.knownConstant(offsetToStart);
+				boost::optional<u256> l = m_expressionClasses.knownConstant(length);
 				if (l && *l == 0)
 					knownToBeIndependent = true;
 				else if (o)
@@ -331,9 +330,9 @@ void CSECodeGenerator::generateClassElement(Id _c, bool _allowSequenced)
 		OptimizerException,
 		"Undefined item requested but not available."
 	);
-	vector<Id> const& arguments = expr.arguments;
-	for (Id arg: boost::adaptors::reverse(arguments))
-		generateClassElement(arg);
+	vector_ref<Id const> arguments = expr.arguments;
+	for (size_t i = arguments.size(); i > 0; --i)
+		generateClassElement(arguments[i - 1]);
 
 	SourceLocation const& itemLocation = expr.item->location();
 	// The arguments are somewhere on the stack now, so it remains to move them at the correct place.
@@ -40,6 +40,8 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 		if (item.type() == Push)
 			pushes[item]++;
 	map<u256, AssemblyItems> pendingReplacements;
+	// Constants often share parts of their decompositions.
+	ComputeMethod::Memo memo;
 	for (auto it: pushes)
 	{
 		AssemblyItem const& item = it.first;
@@ -54,7 +56,7 @@ unsigned ConstantOptimisationMethod::optimiseConstants(
 		bigint literalGas = lit.gasNeeded();
 		CodeCopyMethod copy(params, item.data());
 		bigint copyGas = copy.gasNeeded();
-		ComputeMethod compute(params, item.data());
+		ComputeMethod compute(params, item.data(), &memo);
 		bigint computeGas = compute.gasNeeded();
 		AssemblyItems replacement;
 		if (copyGas < literalGas && copyGas < computeGas)
@@ -192,53 +194,69 @@ AssemblyItems ComputeMethod::findRepresentation(u256 const& _value)
 	else if (dev::bytesRequired(~_value) < dev::bytesRequired(_value))
 		// Negated is shorter to represent
 		return findRepresentation(~_value) + AssemblyItems{Instruction::NOT};
-	else
+	else if (!m_memo)
+		return decompose(_value);
+
+	auto key = make_pair(_value, m_params.multiplicity);
+	auto it = m_memo->find(key);
+	if (it != m_memo->end())
+		return it->second;
+	AssemblyItems routine = decompose(_value);
+	// The search might have been cut short by the step limit, so the result is only reused
+	// if it is the cheapest representation.
+	if (m_maxSteps > 0)
+		m_memo->emplace(key, routine);
+	return routine;
+}
+
+AssemblyItems ComputeMethod::decompose(u256 const& _value)
+{
+	// Decompose value into a * 2**k + b where abs(b) << 2**k
+	// Is not always better, try literal and decomposition method.
+	// With a memo, this is a dynamic programming over all parts that occur in the
+	// decompositions, otherwise the step limit keeps the search from taking exponential time.
+	AssemblyItems routine{u256(_value)};
+	bigint bestGas = gasNeeded(routine);
+	for (unsigned bits = 255; bits > 8 && m_maxSteps > 0; --bits)
 	{
-		// Decompose value into a * 2**k + b where abs(b) << 2**k
-		// Is not always better, try literal and decomposition method.
-		AssemblyItems routine{u256(_value)};
-		bigint bestGas = gasNeeded(routine);
-		for (unsigned bits = 255; bits > 8 && m_maxSteps > 0; --bits)
-		{
-			unsigned gapDetector = unsigned(_value >> (bits - 8)) & 0x1ff;
-			if (gapDetector != 0xff && gapDetector != 0x100)
-				continue;
+		unsigned gapDetector = unsigned(_value >> (bits - 8)) & 0x1ff;
+		if (gapDetector != 0xff && gapDetector != 0x100)
+			continue;
 
-			u256 powerOfTwo = u256(1) << bits;
-			u256 upperPart = _value >> bits;
-			bigint lowerPart = _value & (powerOfTwo - 1);
-			if ((powerOfTwo - lowerPart) < lowerPart)
-			{
-				lowerPart = lowerPart - powerOfTwo; // make it negative
-				upperPart++;
-			}
-			if (upperPart == 0)
-				continue;
-			if (abs(lowerPart) >= (powerOfTwo >> 8))
-				continue;
+		u256 powerOfTwo = u256(1) << bits;
+		u256 upperPart = _value >> bits;
+		bigint lowerPart = _value & (powerOfTwo - 1);
+		if ((powerOfTwo - lowerPart) < lowerPart)
+		{
+			lowerPart = lowerPart - powerOfTwo; // make it negative
+			upperPart++;
+		}
+		if (upperPart == 0)
+			continue;
+		if (abs(lowerPart) >= (powerOfTwo >> 8))
+			continue;
 
-			AssemblyItems newRoutine;
-			if (lowerPart != 0)
-				newRoutine += findRepresentation(u256(abs(lowerPart)));
-			newRoutine += AssemblyItems{u256(bits), u256(2), Instruction::EXP};
-			if (upperPart != 1)
-				newRoutine += findRepresentation(upperPart) + AssemblyItems{Instruction::MUL};
-			if (lowerPart > 0)
-				newRoutine += AssemblyItems{Instruction::ADD};
-			else if (lowerPart < 0)
-				newRoutine.push_back(Instruction::SUB);
+		AssemblyItems newRoutine;
+		if (lowerPart != 0)
+			newRoutine += findRepresentation(u256(abs(lowerPart)));
+		newRoutine += AssemblyItems{u256(bits), u256(2), Instruction::EXP};
+		if (upperPart != 1)
+			newRoutine += findRepresentation(upperPart) + AssemblyItems{Instruction::MUL};
+		if (lowerPart > 0)
+			newRoutine += AssemblyItems{Instruction::ADD};
+		else if (lowerPart < 0)
+			newRoutine.push_back(Instruction::SUB);
 
-			if (m_maxSteps > 0)
-				m_maxSteps--;
-			bigint newGas = gasNeeded(newRoutine);
-			if (newGas < bestGas)
-			{
-				bestGas = move(newGas);
-				routine = move(newRoutine);
-			}
+		if (m_maxSteps > 0)
+			m_maxSteps--;
+		bigint newGas = gasNeeded(newRoutine);
+		if (newGas < bestGas)
+		{
+			bestGas = move(newGas);
+			routine = move(newRoutine);
 		}
-		return routine;
 	}
+	return routine;
 }
 
 bool ComputeMethod::checkRepresentation(u256 const& _value, AssemblyItems const& _routine)
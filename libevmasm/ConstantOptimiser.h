@@ -29,6 +29,8 @@
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
 
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace dev
@@ -134,8 +136,20 @@ protected:
 class ComputeMethod: public ConstantOptimisationMethod
 {
 public:
-	explicit ComputeMethod(Params const& _params, u256 const& _value):
-		ConstantOptimisationMethod(_params, _value)
+	/// Representations found for values and their parts, keyed by the value and the multiplicity.
+	/// Can only be shared between methods whose other parameters are equal.
+	using Memo = std::map<std::pair<u256, size_t>, AssemblyItems>;
+	/// Number of decompositions tried per constant before the search stops.
+	static size_t const defaultMaxSteps = 10000;
+
+	/// Finds a representation of @a _value, reusing and extending @a _memo if it is not null.
+	explicit ComputeMethod(
+		Params const& _params,
+		u256 const& _value,
+		Memo* _memo = nullptr,
+		size_t _maxSteps = defaultMaxSteps
+	):
+		ConstantOptimisationMethod(_params, _value), m_memo(_memo), m_maxSteps(_maxSteps)
 	{
 		m_routine = findRepresentation(m_value);
 		assertThrow(
@@ -154,12 +168,15 @@ public:
 protected:
 	/// Tries to recursively find a way to compute @a _value.
 	AssemblyItems findRepresentation(u256 const& _value);
+	/// @returns the cheapest decomposition of @a _value into smaller values or the literal.
+	AssemblyItems decompose(u256 const& _value);
 	/// Recomputes the value from the calculated representation and checks for correctness.
 	static bool checkRepresentation(u256 const& _value, AssemblyItems const& _routine);
 	bigint gasNeeded(AssemblyItems const& _routine) const;
 
+	Memo* m_memo = nullptr;
 	/// Counter for the complexity of optimization, will stop when it reaches zero.
-	size_t m_maxSteps = 10000;
+	size_t m_maxSteps;
 	AssemblyItems m_routine;
 };
 
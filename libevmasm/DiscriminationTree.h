@@ -0,0 +1,201 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Index over the patterns of simplification rules.
+ */
+
+#pragma once
+
+#include <libevmasm/Instruction.h>
+#include <libdevcore/Common.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Discrimination tree over the patterns of a list of simplification rules. It is used to
+ * find the rules that might match an expression without trying every rule.
+ *
+ * Each pattern is inserted as the sequence of its nodes in pre-order, so patterns with a
+ * common prefix share a path in the tree. A lookup walks the expression in pre-order and
+ * follows every edge compatible with the current subexpression: the edge for its instruction
+ * or constant value, the edge for "any constant" and the edge for "anything", which skips
+ * the whole subexpression. Its cost depends on the depth of the patterns and not on the
+ * number of rules.
+ *
+ * Match groups are not considered, so the candidates still have to be matched fully.
+ */
+class DiscriminationTree
+{
+public:
+	/// Node of a pattern or of an expression.
+	struct Symbol
+	{
+		enum class Kind
+		{
+			Operation,
+			/// Specific constant.
+			Constant,
+			/// Any constant, only used in patterns.
+			AnyConstant,
+			/// Anything in patterns, anything that is neither an operation nor a constant
+			/// in expressions.
+			Any
+		};
+
+		static Symbol operation(Instruction _instruction) { return Symbol{Kind::Operation, _instruction, 0}; }
+		static Symbol constant(u256 const& _value) { return Symbol{Kind::Constant, Instruction::STOP, _value}; }
+		static Symbol anyConstant() { return Symbol{Kind::AnyConstant, Instruction::STOP, 0}; }
+		static Symbol any() { return Symbol{Kind::Any, Instruction::STOP, 0}; }
+
+		Kind kind;
+		Instruction instruction; ///< Only valid if kind is Operation
+		u256 value; ///< Only valid if kind is Constant
+	};
+
+	DiscriminationTree(): m_nodes(1) {}
+
+	/// Adds the pattern of the rule @a _rule, given as its symbols in pre-order. The arguments
+	/// of an operation have to be given in full, even if the pattern does not restrict them.
+	void insert(std::vector<Symbol> const& _pattern, size_t _rule)
+	{
+		size_t node = 0;
+		for (Symbol const& symbol: _pattern)
+		{
+			size_t child = 0;
+			switch (symbol.kind)
+			{
+			case Symbol::Kind::Operation:
+				child = childNode(m_nodes[node].operations[symbol.instruction]);
+				break;
+			case Symbol::Kind::Constant:
+				child = childNode(m_nodes[node].constants[symbol.value]);
+				break;
+			case Symbol::Kind::AnyConstant:
+				child = childNode(m_nodes[node].anyConstant);
+				break;
+			case Symbol::Kind::Any:
+				child = childNode(m_nodes[node].any);
+				break;
+			}
+			node = child;
+		}
+		m_nodes[node].rules.push_back(_rule);
+	}
+
+	/// Stores the rules whose patterns might match @a _expression in @a _candidates, in the order
+	/// in which they were inserted.
+	/// @param _symbolOf has to return the symbol of a subexpression.
+	/// @param _appendArguments has to append the arguments of an operation to the given vector.
+	/// @param _pending is used as a stack of subexpressions still to be visited and is only
+	/// passed in so that its memory can be reused.
+	template <class Term, class SymbolOf, class AppendArguments>
+	void candidates(
+		Term const& _expression,
+		SymbolOf const& _symbolOf,
+		AppendArguments const& _appendArguments,
+		std::vector<Term>& _pending,
+		std::vector<size_t>& _candidates
+	) const
+	{
+		_candidates.clear();
+		_pending.clear();
+		_pending.push_back(_expression);
+		collect(0, _symbolOf, _appendArguments, _pending, _candidates);
+		std::sort(_candidates.begin(), _candidates.end());
+	}
+
+private:
+	struct Node
+	{
+		std::map<Instruction, size_t> operations;
+		std::map<u256, size_t> constants;
+		size_t anyConstant = 0;
+		size_t any = 0;
+		/// Rules whose patterns end at this node.
+		std::vector<size_t> rules;
+	};
+
+	/// @returns the node referenced by @a _edge, creating it if it does not exist yet.
+	/// The root node is never a child, so 0 marks a missing node.
+	size_t childNode(size_t& _edge)
+	{
+		if (_edge)
+			return _edge;
+		size_t child = m_nodes.size();
+		_edge = child;
+		// Invalidates @a _edge.
+		m_nodes.emplace_back();
+		return child;
+	}
+
+	template <class Term, class SymbolOf, class AppendArguments>
+	void collect(
+		size_t _node,
+		SymbolOf const& _symbolOf,
+		AppendArguments const& _appendArguments,
+		std::vector<Term>& _pending,
+		std::vector<size_t>& _candidates
+	) const
+	{
+		Node const& node = m_nodes[_node];
+		if (_pending.empty())
+		{
+			_candidates.insert(_candidates.end(), node.rules.begin(), node.rules.end());
+			return;
+		}
+
+		Term term = _pending.back();
+		_pending.pop_back();
+		if (node.any)
+			collect(node.any, _symbolOf, _appendArguments, _pending, _candidates);
+		Symbol symbol = _symbolOf(term);
+		if (symbol.kind == Symbol::Kind::Constant)
+		{
+			if (node.anyConstant)
+				collect(node.anyConstant, _symbolOf, _appendArguments, _pending, _candidates);
+			auto it = node.constants.find(symbol.value);
+			if (it != node.constants.end())
+				collect(it->second, _symbolOf, _appendArguments, _pending, _candidates);
+		}
+		else if (symbol.kind == Symbol::Kind::Operation)
+		{
+			auto it = node.operations.find(symbol.instruction);
+			if (it != node.operations.end())
+			{
+				size_t pendingSize = _pending.size();
+				_appendArguments(term, _pending);
+				// The first argument has to be visited first.
+				std::reverse(_pending.begin() + pendingSize, _pending.end());
+				collect(it->second, _symbolOf, _appendArguments, _pending, _candidates);
+				_pending.erase(_pending.begin() + pendingSize, _pending.end());
+			}
+		}
+		_pending.push_back(term);
+	}
+
+	std::vector<Node> m_nodes;
+};
+
+}
+}
@@ -23,7 +23,7 @@
 
 #include <libevmasm/ExpressionClasses.h>
 #include <utility>
-#include <tuple>
+#include <limits>
 #include <functional>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/noncopyable.hpp>
@@ -36,23 +36,27 @@ using namespace dev;
 using namespace dev::eth;
 
 
-bool ExpressionClasses::Expression::operator<(ExpressionClasses::Expression const& _other) const
+bool ExpressionClasses::Expression::operator==(ExpressionClasses::Expression const& _other) const
 {
 	assertThrow(!!item && !!_other.item, OptimizerException, "");
-	auto type = item->type();
-	auto otherType = _other.item->type();
-	if (type != otherType)
-		return type < otherType;
-	else if (type == Operation)
-	{
-		auto instr = item->instruction();
-		auto otherInstr = _other.item->instruction();
-		return std::tie(instr, arguments, sequenceNumber) <
-			std::tie(otherInstr, _other.arguments, _other.sequenceNumber);
-	}
+	return
+		*item == *_other.item &&
+		sequenceNumber == _other.sequenceNumber &&
+		arguments.size() == _other.arguments.size() &&
+		equal(arguments.begin(), arguments.end(), _other.arguments.begin());
+}
+
+size_t ExpressionClasses::Expression::hash() const
+{
+	assertThrow(!!item, OptimizerException, "");
+	size_t h = size_t(item->type()) * 31 + sequenceNumber;
+	if (item->type() == Operation)
+		h = h * 31 + size_t(item->instruction());
 	else
-		return std::tie(item->data(), arguments, sequenceNumber) <
-			std::tie(_other.item->data(), _other.arguments, _other.sequenceNumber);
+		h = h * 31 + size_t(item->data() & u256(numeric_limits<size_t>::max()));
+	for (Id argument: arguments)
+		h = h * 31 + argument;
+	return h;
 }
 
 ExpressionClasses::Id ExpressionClasses::find(
@@ -65,19 +69,22 @@ ExpressionClasses::Id ExpressionClasses::find(
 	Expression exp;
 	exp.id = Id(-1);
 	exp.item = &_item;
-	exp.arguments = _arguments;
+	exp.arguments = vector_ref<Id const>(_arguments.data(), _arguments.size());
 	exp.sequenceNumber = _sequenceNumber;
 
 	if (SemanticInformation::isCommutativeOperation(_item))
-		sort(exp.arguments.begin(), exp.arguments.end());
-
-	if (SemanticInformation::isDeterministic(_item))
 	{
-		auto it = m_expressions.find(exp);
-		if (it != m_expressions.end())
-			return it->id;
+		m_sortedArguments = _arguments;
+		sort(m_sortedArguments.begin(), m_sortedArguments.end());
+		exp.arguments = vector_ref<Id const>(m_sortedArguments.data(), m_sortedArguments.size());
 	}
 
+	if (SemanticInformation::isDeterministic(_item))
+		if (Expression const* existing = findExpression(exp))
+			return existing->id;
+
+	// Has to be done before simplification, which can reuse m_sortedArguments.
+	exp.arguments = vector_ref<Id const>(m_arguments.append(exp.arguments.begin(), exp.arguments.end()), exp.arguments.size());
 	if (_copyItem)
 		exp.item = storeItem(_item);
 
@@ -89,7 +96,7 @@ ExpressionClasses::Id ExpressionClasses::find(
 		exp.id = m_representatives.size();
 		m_representatives.push_back(exp);
 	}
-	m_expressions.insert(exp);
+	insertExpression(exp);
 	return exp.id;
 }
 
@@ -100,18 +107,16 @@ void ExpressionClasses::forceEqual(
 	bool _copyItem
 )
 {
-	Expression exp;
-	exp.id = _id;
-	exp.item = &_item;
-	exp.arguments = _arguments;
-
+	Ids arguments = _arguments;
 	if (SemanticInformation::isCommutativeOperation(_item))
-		sort(exp.arguments.begin(), exp.arguments.end());
+		sort(arguments.begin(), arguments.end());
 
-	if (_copyItem)
-		exp.item = storeItem(_item);
+	Expression exp;
+	exp.id = _id;
+	exp.item = _copyItem ? storeItem(_item) : &_item;
+	exp.arguments = vector_ref<Id const>(m_arguments.append(arguments.begin(), arguments.end()), arguments.size());
 
-	m_expressions.insert(exp);
+	insertExpression(exp);
 }
 
 ExpressionClasses::Id ExpressionClasses::newClass(SourceLocation const& _location)
@@ -120,7 +125,7 @@ ExpressionClasses::Id ExpressionClasses::newClass(SourceLocation const& _locatio
 	exp.id = m_representatives.size();
 	exp.item = storeItem(AssemblyItem(UndefinedItem, (u256(1) << 255) + exp.id, _location));
 	m_representatives.push_back(exp);
-	m_expressions.insert(exp);
+	insertExpression(exp);
 	return exp.id;
 }
 
@@ -133,7 +138,7 @@ bool ExpressionClasses::knownToBeDifferent(ExpressionClasses::Id _a, ExpressionC
 bool ExpressionClasses::knownToBeDifferentBy32(ExpressionClasses::Id _a, ExpressionClasses::Id _b)
 {
 	// Try to simplify "_a - _b" and return true iff the value is at least 32 away from zero.
-	u256 const* v = knownConstant(find(Instruction::SUB, {_a, _b}));
+	boost::optional<u256> v = knownConstant(find(Instruction::SUB, {_a, _b}));
 	// forbidden interval is ["-31", 31]
 	return v && *v + 31 > u256(62);
 }
@@ -148,20 +153,19 @@ bool ExpressionClasses::knownNonZero(Id _c)
 	return Pattern(u256(0)).matches(representative(find(Instruction::ISZERO, {_c})), *this);
 }
 
-u256 const* ExpressionClasses::knownConstant(Id _c)
+boost::optional<u256> ExpressionClasses::knownConstant(Id _c)
 {
-	map<unsigned, Expression const*> matchGroups;
+	MatchGroups<Expression> matchGroups{};
 	Pattern constant(Push);
 	constant.setMatchGroup(1, matchGroups);
 	if (!constant.matches(representative(_c), *this))
-		return nullptr;
-	return &constant.d();
+		return boost::none;
+	return constant.d();
 }
 
 AssemblyItem const* ExpressionClasses::storeItem(AssemblyItem const& _item)
 {
-	m_spareAssemblyItems.push_back(make_shared<AssemblyItem>(_item));
-	return m_spareAssemblyItems.back().get();
+	return m_items.emplace(_item);
 }
 
 string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
@@ -181,9 +185,25 @@ string ExpressionClasses::fullDAGToString(ExpressionClasses::Id _id) const
 	return str.str();
 }
 
+void ExpressionClasses::reset()
+{
+	m_representatives.clear();
+	m_expressions.clear();
+	if (++m_generation == 0)
+	{
+		// All generations have been used, so the slots have to be freed explicitly.
+		for (Slot& slot: m_table)
+			slot.generation = 0;
+		m_generation = 1;
+	}
+	m_arguments.reset();
+	m_items.reset();
+}
+
 ExpressionClasses::Id ExpressionClasses::tryToSimplify(Expression const& _expr)
 {
-	static Rules rules;
+	// The rules keep the match groups of the current match, so each thread needs its own copy.
+	static thread_local Rules rules;
 
 	if (
 		!_expr.item ||
@@ -218,3 +238,38 @@ ExpressionClasses::Id ExpressionClasses::rebuildExpression(ExpressionTemplate co
 		arguments.push_back(rebuildExpression(t));
 	return find(_template.item, arguments);
 }
+
+ExpressionClasses::Expression const* ExpressionClasses::findExpression(Expression const& _expr) const
+{
+	if (m_table.empty())
+		return nullptr;
+	Slot const& slot = m_table[tableSlot(_expr)];
+	return slot.generation == m_generation ? &m_expressions[slot.expression] : nullptr;
+}
+
+void ExpressionClasses::insertExpression(Expression const& _expr)
+{
+	if (2 * (m_expressions.size() + 1) > m_table.size())
+	{
+		// Keep the load factor at most 1/2.
+		m_table.assign(max<size_t>(64, 2 * m_table.size()), Slot{0, 0});
+		m_generation = 1;
+		for (size_t i = 0; i < m_expressions.size(); ++i)
+			m_table[tableSlot(m_expressions[i])] = Slot{m_generation, unsigned(i)};
+	}
+	Slot& slot = m_table[tableSlot(_expr)];
+	if (slot.generation == m_generation)
+		// Already present, the first expression is kept.
+		return;
+	slot = Slot{m_generation, unsigned(m_expressions.size())};
+	m_expressions.push_back(_expr);
+}
+
+size_t ExpressionClasses::tableSlot(Expression const& _expr) const
+{
+	size_t mask = m_table.size() - 1;
+	size_t slot = _expr.hash() & mask;
+	while (m_table[slot].generation == m_generation && !(m_expressions[m_table[slot].expression] == _expr))
+		slot = (slot + 1) & mask;
+	return slot;
+}
@@ -23,13 +23,16 @@
 
 #pragma once
 
+#include <libdevcore/Arena.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/vector_ref.h>
 #include <libevmasm/AssemblyItem.h>
 
+#include <boost/optional.hpp>
+
 #include <vector>
 #include <map>
 #include <memory>
-#include <set>
 
 namespace dev
 {
@@ -42,8 +45,10 @@ struct ExpressionTemplate;
 /**
  * Collection of classes of equivalent expressions that can also determine the class of an expression.
  * Identifiers are contiguously assigned to new classes starting from zero.
+ * Arguments and copied items are stored in arenas and all expressions are kept in a hash table,
+ * so that reset() can reuse the memory for the next block.
  */
-class ExpressionClasses
+class ExpressionClasses: boost::noncopyable
 {
 public:
 	using Id = unsigned;
@@ -53,11 +58,14 @@ public:
 	{
 		Id id;
 		AssemblyItem const* item = nullptr;
-		Ids arguments;
+		/// Owned by the ExpressionClasses.
+		vector_ref<Id const> arguments;
 		/// Storage modification sequence, only used for storage and memory operations.
 		unsigned sequenceNumber = 0;
 		/// Behaves as if this was a tuple of (item->type(), item->data(), arguments, sequenceNumber).
-		bool operator<(Expression const& _other) const;
+		bool operator==(Expression const& _other) const;
+		/// @returns a hash that is consistent with operator==.
+		size_t hash() const;
 	};
 
 	/// Retrieves the id of the expression equivalence class resulting from the given item applied to the
@@ -95,9 +103,8 @@ public:
 	/// @returns true if the value of the given class is known to be nonzero.
 	/// @note that this is not the negation of knownZero
 	bool knownNonZero(Id _c);
-	/// @returns a pointer to the value if the given class is known to be a constant,
-	/// and a nullptr otherwise.
-	u256 const* knownConstant(Id _c);
+	/// @returns the value if the given class is known to be a constant.
+	boost::optional<u256> knownConstant(Id _c);
 
 	/// Stores a copy of the given AssemblyItem and returns a pointer to the copy that is valid for
 	/// the lifetime of the ExpressionClasses object.
@@ -105,6 +112,10 @@ public:
 
 	std::string fullDAGToString(Id _id) const;
 
+	/// Removes all classes and items, but keeps the allocated memory. Invalidates all ids
+	/// and pointers to expressions and items.
+	void reset();
+
 private:
 	/// Tries to simplify the given expression.
 	/// @returns its class if it possible or Id(-1) otherwise.
@@ -115,11 +126,34 @@ private:
 
 	std::vector<std::pair<Pattern, std::function<Pattern()>>> createRules() const;
 
+	/// @returns the expression equal to @a _expr or nullptr if there is none.
+	Expression const* findExpression(Expression const& _expr) const;
+	/// Adds @a _expr to the expressions unless an equal expression is already present.
+	void insertExpression(Expression const& _expr);
+	/// @returns the index of the slot in m_table that holds @a _expr or the free slot where
+	/// it would be inserted.
+	size_t tableSlot(Expression const& _expr) const;
+
+	struct Slot
+	{
+		/// The slot is free unless this is equal to m_generation.
+		unsigned generation;
+		/// Index into m_expressions.
+		unsigned expression;
+	};
+
 	/// Expression equivalence class representatives - we only store one item of an equivalence.
 	std::vector<Expression> m_representatives;
 	/// All expression ever encountered.
-	std::set<Expression> m_expressions;
-	std::vector<std::shared_ptr<AssemblyItem>> m_spareAssemblyItems;
+	std::vector<Expression> m_expressions;
+	/// Open addressing hash table of m_expressions, its size is a power of two.
+	std::vector<Slot> m_table;
+	/// Incremented by reset() to free all slots of m_table at once.
+	unsigned m_generation = 1;
+	Arena<Id> m_arguments{4096};
+	Arena<AssemblyItem> m_items{256};
+	/// Buffer for sorting the arguments of commutative operations.
+	Ids m_sortedArguments;
 };
 
 }
@@ -36,6 +36,7 @@
 #pragma warning(pop)
 #pragma GCC diagnostic pop
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/CopyOnWrite.h>
 #include <libdevcore/Exceptions.h>
 #include <libevmasm/ExpressionClasses.h>
 #include <libevmasm/SemanticInformation.h>
@@ -55,6 +56,9 @@ using AssemblyItems = std::vector<AssemblyItem>;
  * The general workings are that for each assembly item that is fed, an equivalence class is
  * derived from the operation and the equivalence class of its arguments. DUPi, SWAPi and some
  * arithmetic instructions are used to infer equivalences while these classes are determined.
+ *
+ * The knowledge is shared between copies of a state until they are modified, so that forking
+ * the state at a branch is cheap.
  */
 class KnownState
 {
@@ -91,11 +95,11 @@ public:
 	StoreOperation feedItem(AssemblyItem const& _item, bool _copyItem = false);
 
 	/// Resets any knowledge about storage.
-	void resetStorage() { m_storageContent.clear(); }
+	void resetStorage() { m_storageContent.reset(); }
 	/// Resets any knowledge about storage.
-	void resetMemory() { m_memoryContent.clear(); }
+	void resetMemory() { m_memoryContent.reset(); }
 	/// Resets any knowledge about the current stack.
-	void resetStack() { m_stackElements.clear(); m_stackHeight = 0; }
+	void resetStack() { m_stackElements.reset(); m_stackHeight = 0; }
 	/// Resets any knowledge.
 	void reset() { resetStorage(); resetMemory(); resetStack(); }
 
@@ -104,10 +108,11 @@ public:
 	/// Replaces the state by the intersection with _other, i.e. only equal knowledge is retained.
 	/// If the stack heighht is different, the smaller one is used and the stack is compared
 	/// relatively.
+	/// Knowledge that is still shared with @a _other is retained without comparing it.
 	/// @param _combineSequenceNumbers if true, sets the sequence number to the maximum of both
 	void reduceToCommonKnowledge(KnownState const& _other, bool _combineSequenceNumbers);
 
-	/// @returns a shared pointer to a copy of this state.
+	/// @returns a shared pointer to a copy of this state. Does not copy the knowledge itself.
 	std::shared_ptr<KnownState> copy() const { return std::make_shared<KnownState>(*this); }
 
 	/// @returns true if the knowledge about the state of both objects is (known to be) equal.
@@ -127,12 +132,14 @@ public:
 	void clearTagUnions();
 
 	int stackHeight() const { return m_stackHeight; }
-	std::map<int, Id> const& stackElements() const { return m_stackElements; }
+	std::map<int, Id> const& stackElements() const { return *m_stackElements; }
 	ExpressionClasses& expressionClasses() const { return *m_expressionClasses; }
 
-	std::map<Id, Id> const& storageContent() const { return m_storageContent; }
+	std::map<Id, Id> const& storageContent() const { return *m_storageContent; }
 
 private:
+	/// Part of reduceToCommonKnowledge that intersects the stack elements.
+	void reduceStackToCommonKnowledge(KnownState const& _other);
 	/// Assigns a new equivalence class to the next sequence number of the given stack element.
 	void setStackElement(int _stackHeight, Id _class);
 	/// Swaps the given stack elements in their next sequence number.
@@ -159,20 +166,20 @@ private:
 	/// Current stack height, can be negative.
 	int m_stackHeight = 0;
 	/// Current stack layout, mapping stack height -> equivalence class
-	std::map<int, Id> m_stackElements;
+	CopyOnWrite<std::map<int, Id>> m_stackElements;
 	/// Current sequence number, this is incremented with each modification to storage or memory.
 	unsigned m_sequenceNumber = 1;
 	/// Knowledge about storage content.
-	std::map<Id, Id> m_storageContent;
+	CopyOnWrite<std::map<Id, Id>> m_storageContent;
 	/// Knowledge about memory content. Keys are memory addresses, note that the values overlap
 	/// and are not contained here if they are not completely known.
-	std::map<Id, Id> m_memoryContent;
+	CopyOnWrite<std::map<Id, Id>> m_memoryContent;
 	/// Keeps record of all Keccak-256 hashes that are computed.
-	std::map<std::vector<Id>, Id> m_knownKeccak256Hashes;
+	CopyOnWrite<std::map<std::vector<Id>, Id>> m_knownKeccak256Hashes;
 	/// Structure containing the classes of equivalent expressions.
 	std::shared_ptr<ExpressionClasses> m_expressionClasses;
 	/// Container for unions of tags stored on the stack.
-	boost::bimap<Id, std::set<u256>> m_tagUnions;
+	CopyOnWrite<boost::bimap<Id, std::set<u256>>> m_tagUnions;
 };
 
 }
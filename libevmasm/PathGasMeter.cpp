@@ -27,8 +27,8 @@ using namespace std;
 using namespace dev;
 using namespace dev::eth;
 
-PathGasMeter::PathGasMeter(AssemblyItems const& _items, solidity::EVMVersion _evmVersion):
-	m_items(_items), m_evmVersion(_evmVersion)
+PathGasMeter::PathGasMeter(AssemblyItems const& _items, solidity::EVMVersion _evmVersion, size_t _maxSteps):
+	m_items(_items), m_evmVersion(_evmVersion), m_maxSteps(_maxSteps)
 {
 	for (size_t i = 0; i < m_items.size(); ++i)
 		if (m_items[i].type() == Tag)
@@ -40,10 +40,14 @@ GasMeter::GasConsumption PathGasMeter::estimateMax(
 	shared_ptr<KnownState> const& _state
 )
 {
+	m_queue.clear();
+	m_steps = 0;
+	m_approximate = false;
+
 	auto path = unique_ptr<GasPath>(new GasPath());
 	path->index = _startIndex;
 	path->state = _state->copy();
-	m_queue.push_back(move(path));
+	queue(move(path));
 
 	GasMeter::GasConsumption gas;
 	while (!m_queue.empty() && !gas.isInfinite)
@@ -51,12 +55,58 @@ GasMeter::GasConsumption PathGasMeter::estimateMax(
 	return gas;
 }
 
+void PathGasMeter::queue(unique_ptr<GasPath> _path)
+{
+	auto& paths = m_queue[_path->index];
+	for (auto& queuedPath: paths)
+		if (merge(*queuedPath, *_path, m_approximate))
+			return;
+	paths.push_back(move(_path));
+}
+
+bool PathGasMeter::merge(GasPath& _target, GasPath const& _path, bool _approximate)
+{
+	if (
+		!_approximate && (
+			_target.largestMemoryAccess != _path.largestMemoryAccess ||
+			_target.state->stackHeight() != _path.state->stackHeight() ||
+			!(*_target.state == *_path.state)
+		)
+	)
+		return false;
+
+	// The state is the same or an upper bound of the cost is needed, so the analysis continues
+	// with the larger gas, the smaller memory size (more expansion costs) and all visited
+	// jumpdests (a loop in either path results in an infinite bound).
+	_target.gas = max(_target.gas, _path.gas);
+	_target.largestMemoryAccess = min(_target.largestMemoryAccess, _path.largestMemoryAccess);
+	_target.visitedJumpdests.insert(_path.visitedJumpdests.begin(), _path.visitedJumpdests.end());
+	if (_approximate)
+		_target.state->reduceToCommonKnowledge(*_path.state, true);
+	return true;
+}
+
 GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 {
 	assertThrow(!m_queue.empty(), OptimizerException, "");
 
-	unique_ptr<GasPath> path = move(m_queue.back());
-	m_queue.pop_back();
+	if (!m_approximate && m_steps > m_maxSteps)
+	{
+		// Merge all queued paths at each position, later paths are merged when they are queued.
+		m_approximate = true;
+		for (auto& paths: m_queue)
+			while (paths.second.size() > 1)
+			{
+				merge(*paths.second.front(), *paths.second.back(), true);
+				paths.second.pop_back();
+			}
+	}
+
+	auto first = m_queue.begin();
+	unique_ptr<GasPath> path = move(first->second.back());
+	first->second.pop_back();
+	if (first->second.empty())
+		m_queue.erase(first);
 
 	shared_ptr<KnownState> state = path->state;
 	GasMeter meter(state, m_evmVersion, path->largestMemoryAccess);
@@ -73,11 +123,22 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 	set<u256> jumpTags;
 	for (; index < m_items.size() && !gas.isInfinite; ++index)
 	{
+		if (++m_steps / 2 > m_maxSteps)
+			return GasMeter::GasConsumption::infinite();
 		bool branchStops = false;
 		jumpTags.clear();
 		AssemblyItem const& item = m_items.at(index);
 		if (item.type() == Tag || item == AssemblyItem(Instruction::JUMPDEST))
 		{
+			if (index != path->index && m_queue.count(index))
+			{
+				// Other paths are waiting at this position, so continue together with them.
+				path->index = index;
+				path->gas = gas;
+				path->largestMemoryAccess = meter.largestMemoryAccess();
+				queue(move(path));
+				return gas;
+			}
 			// Do not allow any backwards jump. This is quite restrictive but should work for
 			// the simplest things.
 			if (path->visitedJumpdests.count(index))
@@ -117,7 +178,7 @@ GasMeter::GasConsumption PathGasMeter::handleQueueItem()
 			newPath->largestMemoryAccess = meter.largestMemoryAccess();
 			newPath->state = state->copy();
 			newPath->visitedJumpdests = path->visitedJumpdests;
-			m_queue.push_back(move(newPath));
+			queue(move(newPath));
 		}
 
 		if (branchStops)
@@ -25,6 +25,7 @@
 
 #include <libsolidity/interface/EVMVersion.h>
 
+#include <map>
 #include <set>
 #include <vector>
 #include <memory>
@@ -49,21 +50,46 @@ struct GasPath
  * Computes an upper bound on the gas usage of a computation starting at a certain position in
  * a list of AssemblyItems in a given state until the computation stops.
  * Can be used to estimate the gas usage of functions on any given input.
+ *
+ * Paths are analysed in the order of their position. Paths that reach the same position in
+ * the same state are merged. If more than the given number of assembly items has been
+ * analysed, paths reaching the same position are merged regardless of their state, which
+ * results in a less precise upper bound. If twice that number is exceeded, the result is
+ * infinite.
  */
 class PathGasMeter
 {
 public:
-	explicit PathGasMeter(AssemblyItems const& _items, solidity::EVMVersion _evmVersion);
+	/// Number of assembly items that are analysed before paths are merged regardless of their state.
+	static size_t const defaultMaxSteps = 1000000;
+
+	explicit PathGasMeter(
+		AssemblyItems const& _items,
+		solidity::EVMVersion _evmVersion,
+		size_t _maxSteps = defaultMaxSteps
+	);
 
 	GasMeter::GasConsumption estimateMax(size_t _startIndex, std::shared_ptr<KnownState> const& _state);
 
 private:
 	GasMeter::GasConsumption handleQueueItem();
+	/// Adds @a _path to the queue or merges it into a queued path at the same position.
+	void queue(std::unique_ptr<GasPath> _path);
+	/// Merges @a _path into @a _target if the analysis of both would result in the same gas
+	/// or, if @a _approximate is true, into an upper bound of both.
+	/// @returns true if the paths were merged.
+	static bool merge(GasPath& _target, GasPath const& _path, bool _approximate);
 
-	std::vector<std::unique_ptr<GasPath>> m_queue;
+	/// Paths to be analysed by their position.
+	std::map<size_t, std::vector<std::unique_ptr<GasPath>>> m_queue;
 	std::map<u256, size_t> m_tagPositions;
 	AssemblyItems const& m_items;
 	solidity::EVMVersion m_evmVersion;
+	size_t m_maxSteps;
+	/// Number of assembly items analysed so far.
+	size_t m_steps = 0;
+	/// True if paths are merged regardless of their state.
+	bool m_approximate = false;
 };
 
 }
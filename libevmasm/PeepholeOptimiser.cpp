@@ -22,8 +22,11 @@
 #include "PeepholeOptimiser.h"
 
 #include <libevmasm/AssemblyItem.h>
+#include <libevmasm/Exceptions.h>
 #include <libevmasm/SemanticInformation.h>
 
+#include <libdevcore/Assertions.h>
+
 using namespace std;
 using namespace dev::eth;
 using namespace dev;
@@ -33,12 +36,16 @@ using namespace dev;
 namespace
 {
 
-struct OptimiserState
-{
-	AssemblyItems const& items;
-	size_t i;
-	std::back_insert_iterator<AssemblyItems> out;
-};
+/// Tries to replace items at the start of [@a _in, @a _end) by the items written to @a _out.
+/// @returns the number of items replaced or zero if the rule does not apply.
+using Rule = size_t(*)(
+	AssemblyItems::const_iterator _in,
+	AssemblyItems::const_iterator _end,
+	std::back_insert_iterator<AssemblyItems> _out
+);
+
+/// Maximum number of items a rule looks at, apart from UnreachableCode.
+size_t const maxWindowSize = 3;
 
 template <class Method, size_t Arguments>
 struct ApplyRule
@@ -72,27 +79,18 @@ struct ApplyRule<Method, 1>
 template <class Method, size_t WindowSize>
 struct SimplePeepholeOptimizerMethod
 {
-	static bool apply(OptimiserState& _state)
-	{
-		if (
-			_state.i + WindowSize <= _state.items.size() &&
-			ApplyRule<Method, WindowSize>::applyRule(_state.items.begin() + _state.i, _state.out)
-		)
-		{
-			_state.i += WindowSize;
-			return true;
-		}
-		else
-			return false;
-	}
-};
+	static_assert(WindowSize <= maxWindowSize, "");
 
-struct Identity: SimplePeepholeOptimizerMethod<Identity, 1>
-{
-	static bool applySimple(AssemblyItem const& _item, std::back_insert_iterator<AssemblyItems> _out)
+	static size_t apply(
+		AssemblyItems::const_iterator _in,
+		AssemblyItems::const_iterator _end,
+		std::back_insert_iterator<AssemblyItems> _out
+	)
 	{
-		*_out = _item;
-		return true;
+		if (size_t(_end - _in) >= WindowSize && ApplyRule<Method, WindowSize>::applyRule(_in, _out))
+			return WindowSize;
+		else
+			return 0;
 	}
 };
 
@@ -207,70 +205,160 @@ struct TagConjunctions: SimplePeepholeOptimizerMethod<TagConjunctions, 3>
 /// Removes everything after a JUMP (or similar) until the next JUMPDEST.
 struct UnreachableCode
 {
-	static bool apply(OptimiserState& _state)
+	static size_t apply(
+		AssemblyItems::const_iterator _in,
+		AssemblyItems::const_iterator _end,
+		std::back_insert_iterator<AssemblyItems> _out
+	)
 	{
-		auto it = _state.items.begin() + _state.i;
-		auto end = _state.items.end();
-		if (it == end)
-			return false;
 		if (
-			it[0] != Instruction::JUMP &&
-			it[0] != Instruction::RETURN &&
-			it[0] != Instruction::STOP &&
-			it[0] != Instruction::INVALID &&
-			it[0] != Instruction::SELFDESTRUCT &&
-			it[0] != Instruction::REVERT
+			_in[0] != Instruction::JUMP &&
+			_in[0] != Instruction::RETURN &&
+			_in[0] != Instruction::STOP &&
+			_in[0] != Instruction::INVALID &&
+			_in[0] != Instruction::SELFDESTRUCT &&
+			_in[0] != Instruction::REVERT
 		)
-			return false;
+			return 0;
 
 		size_t i = 1;
-		while (it + i != end && it[i].type() != Tag)
+		while (_in + i != _end && _in[i].type() != Tag)
 			i++;
 		if (i > 1)
 		{
-			*_state.out = it[0];
-			_state.i += i;
-			return true;
+			*_out = _in[0];
+			return i;
 		}
 		else
-			return false;
+			return 0;
 	}
 };
 
-void applyMethods(OptimiserState&)
+/// Rules that can apply to a window starting with a given item, in the order they are tried.
+class RuleTable
 {
-	assertThrow(false, OptimizerException, "Peephole optimizer failed to apply identity.");
-}
+public:
+	static RuleTable const& instance()
+	{
+		static RuleTable const table;
+		return table;
+	}
 
-template <typename Method, typename... OtherMethods>
-void applyMethods(OptimiserState& _state, Method, OtherMethods... _other)
-{
-	if (!Method::apply(_state))
-		applyMethods(_state, _other...);
-}
+	std::vector<Rule> const& rules(AssemblyItem const& _item) const
+	{
+		if (_item.type() == Operation)
+			return m_operationRules[uint8_t(_item.instruction())];
+		else
+			return m_typeRules[_item.type()];
+	}
 
-size_t numberOfPops(AssemblyItems const& _items)
+private:
+	RuleTable()
+	{
+		for (unsigned i = 0; i < 0x100; ++i)
+			if (isValidInstruction(Instruction(i)))
+				addRules(AssemblyItem(Instruction(i)), m_operationRules[i]);
+		for (auto type: {Push, PushString, PushTag, PushSub, PushSubSize, PushProgramSize, PushData, PushLibraryAddress})
+			addRules(AssemblyItem(type, 0), m_typeRules[type]);
+	}
+
+	/// Adds the rules that can apply to windows starting with @a _item, which has to be
+	/// representative for all items of its instruction or type.
+	static void addRules(AssemblyItem const& _item, std::vector<Rule>& _rules)
+	{
+		auto t = _item.type();
+		bool isPush = t == Push || t == PushString || t == PushTag || t == PushSub ||
+			t == PushSubSize || t == PushProgramSize || t == PushData || t == PushLibraryAddress;
+		if (isPush || SemanticInformation::isDupInstruction(_item))
+			_rules.push_back(PushPop::apply);
+		if (t == Operation)
+			_rules.push_back(OpPop::apply);
+		if (t == Push)
+			_rules.push_back(DoublePush::apply);
+		if (SemanticInformation::isSwapInstruction(_item))
+			_rules.push_back(DoubleSwap::apply);
+		if (t == PushTag)
+			_rules.push_back(JumpToNext::apply);
+		if (t == Operation)
+			_rules.push_back(UnreachableCode::apply);
+		if (t == PushTag)
+			_rules.push_back(TagConjunctions::apply);
+	}
+
+	std::vector<Rule> m_operationRules[0x100];
+	std::vector<Rule> m_typeRules[PushDeployTimeAddress + 1];
+};
+
+/// @returns true if replacing the @a _replaced items starting at @a _in by @a _replacement
+/// improves the code: It has to consist of fewer items or of as many items with fewer bytes
+/// or more POPs. OpPop, for example, grows the code if the operation takes more than two
+/// arguments and the POPs cannot be removed afterwards.
+bool isImprovement(AssemblyItems::const_iterator _in, size_t _replaced, AssemblyItems const& _replacement)
 {
-	return std::count(_items.begin(), _items.end(), Instruction::POP);
+	if (_replacement.size() != _replaced)
+		return _replacement.size() < _replaced;
+	size_t bytesBefore = 0;
+	size_t popsBefore = 0;
+	for (size_t i = 0; i < _replaced; ++i)
+	{
+		bytesBefore += _in[i].bytesRequired(3);
+		popsBefore += _in[i] == Instruction::POP ? 1 : 0;
+	}
+	return
+		bytesRequired(_replacement, 3) < bytesBefore ||
+		size_t(count(_replacement.begin(), _replacement.end(), Instruction::POP)) > popsBefore;
 }
 
 }
 
 bool PeepholeOptimiser::optimise()
 {
-	OptimiserState state {m_items, 0, std::back_inserter(m_optimisedItems)};
-	while (state.i < m_items.size())
-		applyMethods(state, PushPop(), OpPop(), DoublePush(), DoubleSwap(), JumpToNext(), UnreachableCode(), TagConjunctions(), Identity());
-	if (m_optimisedItems.size() < m_items.size() || (
-		m_optimisedItems.size() == m_items.size() && (
-			eth::bytesRequired(m_optimisedItems, 3) < eth::bytesRequired(m_items, 3) ||
-			numberOfPops(m_optimisedItems) > numberOfPops(m_items)
-		)
-	))
+	// The items before m_items[write] are optimised and the items from m_items[read] on still
+	// have to be looked at. After a rule applies, its replacement is put in front of the
+	// remaining items together with the optimised items it could form a window with, so
+	// only the surroundings of the change are looked at again.
+	// A replacement is only accepted if it improves the code (see isImprovement), so this
+	// terminates.
+	RuleTable const& table = RuleTable::instance();
+	AssemblyItems replacement;
+	size_t write = 0;
+	size_t read = 0;
+	bool optimised = false;
+	while (read < m_items.size())
 	{
-		m_items = std::move(m_optimisedItems);
-		return true;
+		size_t replaced = 0;
+		for (Rule rule: table.rules(m_items[read]))
+		{
+			replacement.clear();
+			replaced = rule(m_items.begin() + read, m_items.end(), back_inserter(replacement));
+			if (replaced > 0 && isImprovement(m_items.begin() + read, replaced, replacement))
+				break;
+			replaced = 0;
+		}
+		if (replaced == 0)
+		{
+			if (write != read)
+				m_items[write] = std::move(m_items[read]);
+			write++;
+			read++;
+			continue;
+		}
+
+		optimised = true;
+		read += replaced;
+		size_t gap = read - write;
+		// Replacements never have more items than they replace, so they fit into the gap.
+		assertThrow(replacement.size() <= gap, OptimizerException, "Peephole replacement grows the code.");
+		read -= replacement.size();
+		std::move(replacement.begin(), replacement.end(), m_items.begin() + read);
+		for (size_t i = 1; i < maxWindowSize && write > 0; ++i)
+		{
+			--write;
+			--read;
+			if (write != read)
+				m_items[read] = std::move(m_items[write]);
+		}
 	}
-	else
-		return false;
+	m_items.erase(m_items.begin() + write, m_items.end());
+	return optimised;
 }
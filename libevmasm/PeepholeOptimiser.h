@@ -38,16 +38,22 @@ public:
 	virtual bool apply(AssemblyItems::const_iterator _in, std::back_insert_iterator<AssemblyItems> _out);
 };
 
+/**
+ * Applies local rewrite rules to a sequence of assembly items in place. The rules are looked up
+ * by the first item of the window they apply to and the code around a rewrite is revisited
+ * until no rule applies anymore.
+ */
 class PeepholeOptimiser
 {
 public:
 	explicit PeepholeOptimiser(AssemblyItems& _items): m_items(_items) {}
 
+	/// Optimises the items until no rule applies anymore.
+	/// @returns true if any rule was applied.
 	bool optimise();
 
 private:
 	AssemblyItems& m_items;
-	AssemblyItems m_optimisedItems;
 };
 
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 
 namespace dev
@@ -27,6 +28,11 @@ namespace dev
 namespace solidity
 {
 
+/// Expressions matched by the patterns of each match group of a rule, indexed by the
+/// identifier of the group. Identifier 0 means "no group" and is not used.
+template <class Expression>
+using MatchGroups = std::array<Expression const*, 8>;
+
 /**
  * Rule that contains a pattern, an action that can be applied
  * after the pattern has matched and a bool that indicates
@@ -42,13 +42,34 @@ SimplificationRule<Pattern> const* Rules::findFirstMatch(
 	ExpressionClasses const& _classes
 )
 {
+	using Symbol = DiscriminationTree::Symbol;
+
 	resetMatchGroups();
 
 	assertThrow(_expr.item, OptimizerException, "");
-	for (auto const& rule: m_rules[byte(_expr.item->instruction())])
+	m_tree.candidates(
+		&_expr,
+		[](Expression const* _e)
+		{
+			if (_e->item && _e->item->type() == Operation)
+				return Symbol::operation(_e->item->instruction());
+			else if (_e->item && _e->item->type() == Push)
+				return Symbol::constant(_e->item->data());
+			else
+				return Symbol::any();
+		},
+		[&](Expression const* _e, vector<Expression const*>& _arguments)
+		{
+			for (auto const& argument: _e->arguments)
+				_arguments.push_back(&_classes.representative(argument));
+		},
+		m_pending,
+		m_candidates
+	);
+	for (size_t index: m_candidates)
 	{
-		if (rule.pattern.matches(_expr, _classes))
-			return &rule;
+		if (m_rules[index].pattern.matches(_expr, _classes))
+			return &m_rules[index];
 		resetMatchGroups();
 	}
 	return nullptr;
@@ -62,7 +83,10 @@ void Rules::addRules(std::vector<SimplificationRule<Pattern>> const& _rules)
 
 void Rules::addRule(SimplificationRule<Pattern> const& _rule)
 {
-	m_rules[byte(_rule.pattern.instruction())].push_back(_rule);
+	vector<DiscriminationTree::Symbol> symbols;
+	_rule.pattern.appendSymbols(symbols);
+	m_tree.insert(symbols, m_rules.size());
+	m_rules.push_back(_rule);
 }
 
 Rules::Rules()
@@ -91,8 +115,9 @@ Pattern::Pattern(Instruction _instruction, std::vector<Pattern> const& _argument
 {
 }
 
-void Pattern::setMatchGroup(unsigned _group, map<unsigned, Expression const*>& _matchGroups)
+void Pattern::setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups)
 {
+	assertThrow(0 < _group && _group < _matchGroups.size(), OptimizerException, "Invalid match group.");
 	m_matchGroup = _group;
 	m_matchGroups = &_matchGroups;
 }
@@ -103,7 +128,7 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 		return false;
 	if (m_matchGroup)
 	{
-		if (!m_matchGroups->count(m_matchGroup))
+		if (!(*m_matchGroups)[m_matchGroup])
 			(*m_matchGroups)[m_matchGroup] = &_expr;
 		else if ((*m_matchGroups)[m_matchGroup]->id != _expr.id)
 			return false;
@@ -115,6 +140,24 @@ bool Pattern::matches(Expression const& _expr, ExpressionClasses const& _classes
 	return true;
 }
 
+void Pattern::appendSymbols(vector<DiscriminationTree::Symbol>& _symbols) const
+{
+	using Symbol = DiscriminationTree::Symbol;
+	if (m_type == Operation)
+	{
+		_symbols.push_back(Symbol::operation(m_instruction));
+		// Without argument patterns, the arguments are not restricted.
+		if (m_arguments.empty())
+			_symbols.resize(_symbols.size() + instructionInfo(m_instruction).args, Symbol::any());
+		for (Pattern const& argument: m_arguments)
+			argument.appendSymbols(_symbols);
+	}
+	else if (m_type == Push)
+		_symbols.push_back(m_requireDataMatch ? Symbol::constant(data()) : Symbol::anyConstant());
+	else
+		_symbols.push_back(Symbol::any());
+}
+
 AssemblyItem Pattern::toAssemblyItem(SourceLocation const& _location) const
 {
 	if (m_type == Operation)
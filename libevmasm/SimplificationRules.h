@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <libevmasm/DiscriminationTree.h>
 #include <libevmasm/ExpressionClasses.h>
 #include <libevmasm/SimplificationRule.h>
 
@@ -57,12 +58,17 @@ private:
 	void addRules(std::vector<SimplificationRule<Pattern>> const& _rules);
 	void addRule(SimplificationRule<Pattern> const& _rule);
 
-	void resetMatchGroups() { m_matchGroups.clear(); }
+	void resetMatchGroups() { m_matchGroups.fill(nullptr); }
 
-	std::map<unsigned, Expression const*> m_matchGroups;
+	MatchGroups<Expression> m_matchGroups{};
 	/// Pattern to match, replacement to be applied and flag indicating whether
 	/// the replacement might remove some elements (except constants).
-	std::vector<SimplificationRule<Pattern>> m_rules[256];
+	std::vector<SimplificationRule<Pattern>> m_rules;
+	/// Index over the patterns of m_rules.
+	DiscriminationTree m_tree;
+	/// Buffers for looking up candidates in m_tree, kept to avoid reallocations.
+	std::vector<Expression const*> m_pending;
+	std::vector<size_t> m_candidates;
 };
 
 /**
@@ -87,9 +93,11 @@ public:
 	/// Sets this pattern to be part of the match group with the identifier @a _group.
 	/// Inside one rule, all patterns in the same match group have to match expressions from the
 	/// same expression equivalence class.
-	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
+	void setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(Expression const& _expr, ExpressionClasses const& _classes) const;
+	/// Appends the nodes of this pattern in pre-order to @a _symbols, for DiscriminationTree.
+	void appendSymbols(std::vector<DiscriminationTree::Symbol>& _symbols) const;
 
 	AssemblyItem toAssemblyItem(SourceLocation const& _location) const;
 	std::vector<Pattern> arguments() const { return m_arguments; }
@@ -97,7 +105,7 @@ public:
 	/// @returns the id of the matched expression if this pattern is part of a match group.
 	Id id() const { return matchGroupValue().id; }
 	/// @returns the data of the matched expression if this pattern is part of a match group.
-	u256 const& d() const { return matchGroupValue().item->data(); }
+	u256 d() const { return matchGroupValue().item->data(); }
 
 	std::string toString() const;
 
@@ -119,7 +127,7 @@ private:
 	std::shared_ptr<u256> m_data; ///< Only valid if m_type is not Operation
 	std::vector<Pattern> m_arguments;
 	unsigned m_matchGroup = 0;
-	std::map<unsigned, Expression const*>* m_matchGroups = nullptr;
+	MatchGroups<Expression>* m_matchGroups = nullptr;
 };
 
 /**
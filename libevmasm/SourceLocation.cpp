@@ -0,0 +1,112 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SourceLocation.cpp
+ * @date 2018
+ */
+
+#include <libevmasm/SourceLocation.h>
+
+#include <libdevcore/Assertions.h>
+#include <libevmasm/Exceptions.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// Names are stored in chunks that are never moved or freed, so the names can be read without
+/// locking while new names are added. Chunk i holds firstChunkSize << i names, so a few chunks
+/// suffice for any number of sources.
+class SourceNameTable
+{
+public:
+	int id(string const& _name)
+	{
+		lock_guard<mutex> guard(m_writeLock);
+		auto it = m_ids.find(_name);
+		if (it != m_ids.end())
+			return it->second;
+		size_t id = m_size.load(memory_order_relaxed);
+		size_t offset;
+		size_t chunk = chunkOf(id, offset);
+		assertThrow(chunk < maxChunks, eth::AssemblyException, "Too many sources.");
+		if (offset == 0)
+			m_chunks[chunk].store(new string[firstChunkSize << chunk], memory_order_relaxed);
+		m_chunks[chunk].load(memory_order_relaxed)[offset] = _name;
+		m_ids[_name] = int(id);
+		// Publishes the chunk and the name to readers that see the new size.
+		m_size.store(id + 1, memory_order_release);
+		return int(id);
+	}
+
+	string const& name(int _id) const
+	{
+		assertThrow(
+			_id >= 0 && size_t(_id) < m_size.load(memory_order_acquire),
+			eth::AssemblyException,
+			"Unknown source ID."
+		);
+		size_t offset;
+		size_t chunk = chunkOf(size_t(_id), offset);
+		return m_chunks[chunk].load(memory_order_relaxed)[offset];
+	}
+
+private:
+	static size_t const firstChunkSize = 64;
+	static size_t const maxChunks = 32;
+
+	/// @returns the chunk the name with ID @a _id is stored in and its index in the chunk in @a _offset.
+	static size_t chunkOf(size_t _id, size_t& _offset)
+	{
+		size_t chunk = 0;
+		_offset = _id;
+		while (_offset >= firstChunkSize << chunk)
+		{
+			_offset -= firstChunkSize << chunk;
+			chunk++;
+		}
+		return chunk;
+	}
+
+	mutex m_writeLock;
+	unordered_map<string, int> m_ids;
+	atomic<size_t> m_size{0};
+	atomic<string*> m_chunks[maxChunks] = {};
+};
+
+SourceNameTable& sourceNameTable()
+{
+	static SourceNameTable table;
+	return table;
+}
+
+}
+
+int SourceNames::id(string const& _name)
+{
+	return sourceNameTable().id(_name);
+}
+
+string const& SourceNames::name(int _id)
+{
+	return sourceNameTable().name(_id);
+}
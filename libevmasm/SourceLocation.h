@@ -22,7 +22,6 @@
 
 #pragma once
 
-#include <memory>
 #include <string>
 #include <ostream>
 #include <tuple>
@@ -31,45 +30,52 @@
 namespace dev
 {
 
+/**
+ * Process-wide table of source names, so that source locations can refer to their source
+ * by a small integer. IDs are assigned in the order the names are first seen and stay valid
+ * for the lifetime of the process, so the table only grows by the number of distinct names,
+ * not by the number of compilations. The table is safe to use from multiple threads and
+ * looking up names does not lock.
+ */
+class SourceNames
+{
+public:
+	/// @returns the ID of the source named @a _name, registering the name if it is new.
+	static int id(std::string const& _name);
+	/// @returns the name of the source with ID @a _id, which has to be a registered ID.
+	/// The reference stays valid for the lifetime of the process.
+	static std::string const& name(int _id);
+};
+
 /**
  * Representation of an interval of source positions.
  * The interval includes start and excludes end.
  */
 struct SourceLocation
 {
-	SourceLocation(): start(-1), end(-1) { }
-	SourceLocation(int _start, int _end, std::shared_ptr<std::string const> _sourceName):
-		start(_start), end(_end), sourceName(_sourceName) { }
-	SourceLocation(SourceLocation&& _other) noexcept:
-		start(_other.start),
-		end(_other.end),
-		sourceName(std::move(_other.sourceName))
-	{}
-	SourceLocation(SourceLocation const&) = default;
-	SourceLocation& operator=(SourceLocation const&) = default;
-	SourceLocation& operator=(SourceLocation&& _other) noexcept
-	{
-		start = _other.start;
-		end = _other.end;
-		sourceName = std::move(_other.sourceName);
-		return *this;
-	}
+	SourceLocation(): start(-1), end(-1), sourceID(-1) { }
+	SourceLocation(int _start, int _end, int _sourceID):
+		start(_start), end(_end), sourceID(_sourceID) { }
 
 	bool operator==(SourceLocation const& _other) const
 	{
-		return start == _other.start && end == _other.end &&
-			((!sourceName && !_other.sourceName) || (sourceName && _other.sourceName && *sourceName == *_other.sourceName));
+		return start == _other.start && end == _other.end && sourceID == _other.sourceID;
 	}
 	bool operator!=(SourceLocation const& _other) const { return !operator==(_other); }
+	/// Orders locations by source name and then by position.
 	inline bool operator<(SourceLocation const& _other) const;
 	inline bool contains(SourceLocation const& _other) const;
 	inline bool intersects(SourceLocation const& _other) const;
 
 	bool isEmpty() const { return start == -1 && end == -1; }
 
+	/// @returns the name of the source or nullptr if the location does not refer to a source.
+	std::string const* sourceName() const { return sourceID < 0 ? nullptr : &SourceNames::name(sourceID); }
+
 	int start;
 	int end;
-	std::shared_ptr<std::string const> sourceName;
+	/// ID of the source in the SourceNames table or -1.
+	int sourceID;
 };
 
 /// Stream output for Location (used e.g. in boost exceptions).
@@ -77,27 +83,31 @@ inline std::ostream& operator<<(std::ostream& _out, SourceLocation const& _locat
 {
 	if (_location.isEmpty())
 		return _out << "NO_LOCATION_SPECIFIED";
-	return _out << *_location.sourceName << "[" << _location.start << "," << _location.end << ")";
+	if (_location.sourceName())
+		_out << *_location.sourceName();
+	return _out << "[" << _location.start << "," << _location.end << ")";
 }
 
 bool SourceLocation::operator<(SourceLocation const& _other) const
 {
-	if (!sourceName || !_other.sourceName)
-		return std::make_tuple(int(!!sourceName), start, end) < std::make_tuple(int(!!_other.sourceName), _other.start, _other.end);
+	if (sourceID == _other.sourceID)
+		return std::make_tuple(start, end) < std::make_tuple(_other.start, _other.end);
+	else if (sourceID < 0 || _other.sourceID < 0)
+		return sourceID < _other.sourceID;
 	else
-		return std::make_tuple(*sourceName, start, end) < std::make_tuple(*_other.sourceName, _other.start, _other.end);
+		return *sourceName() < *_other.sourceName();
 }
 
 bool SourceLocation::contains(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || ((!sourceName || !_other.sourceName || *sourceName != *_other.sourceName) && (sourceName || _other.sourceName)))
+	if (isEmpty() || _other.isEmpty() || sourceID != _other.sourceID)
 		return false;
 	return start <= _other.start && _other.end <= end;
 }
 
 bool SourceLocation::intersects(SourceLocation const& _other) const
 {
-	if (isEmpty() || _other.isEmpty() || ((!sourceName || !_other.sourceName || *sourceName != *_other.sourceName) && (sourceName || _other.sourceName)))
+	if (isEmpty() || _other.isEmpty() || sourceID != _other.sourceID)
 		return false;
 	return _other.start < end && start < _other.end;
 }
@@ -39,14 +39,34 @@ SimplificationRule<Pattern> const* SimplificationRules::findFirstMatch(Expressio
 	if (_expr.type() != typeid(FunctionalInstruction))
 		return nullptr;
 
-	static SimplificationRules rules;
+	// The rules keep the match groups of the current match, so each thread needs its own copy.
+	static thread_local SimplificationRules rules;
 
-	FunctionalInstruction const& instruction = boost::get<FunctionalInstruction>(_expr);
-	for (auto const& rule: rules.m_rules[byte(instruction.instruction)])
+	using Symbol = solidity::DiscriminationTree::Symbol;
+	rules.m_tree.candidates(
+		&_expr,
+		[](Expression const* _e)
+		{
+			if (_e->type() == typeid(FunctionalInstruction))
+				return Symbol::operation(boost::get<FunctionalInstruction>(*_e).instruction);
+			else if (_e->type() == typeid(Literal) && boost::get<Literal>(*_e).kind == assembly::LiteralKind::Number)
+				return Symbol::constant(u256(boost::get<Literal>(*_e).value));
+			else
+				return Symbol::any();
+		},
+		[](Expression const* _e, vector<Expression const*>& _arguments)
+		{
+			for (auto const& argument: boost::get<FunctionalInstruction>(*_e).arguments)
+				_arguments.push_back(&argument);
+		},
+		rules.m_pending,
+		rules.m_candidates
+	);
+	for (size_t index: rules.m_candidates)
 	{
 		rules.resetMatchGroups();
-		if (rule.pattern.matches(_expr))
-			return &rule;
+		if (rules.m_rules[index].pattern.matches(_expr))
+			return &rules.m_rules[index];
 	}
 	return nullptr;
 }
@@ -59,7 +79,10 @@ void SimplificationRules::addRules(vector<SimplificationRule<Pattern>> const& _r
 
 void SimplificationRules::addRule(SimplificationRule<Pattern> const& _rule)
 {
-	m_rules[byte(_rule.pattern.instruction())].push_back(_rule);
+	vector<solidity::DiscriminationTree::Symbol> symbols;
+	_rule.pattern.appendSymbols(symbols);
+	m_tree.insert(symbols, m_rules.size());
+	m_rules.push_back(_rule);
 }
 
 SimplificationRules::SimplificationRules()
@@ -88,8 +111,9 @@ Pattern::Pattern(solidity::Instruction _instruction, vector<Pattern> const& _arg
 {
 }
 
-void Pattern::setMatchGroup(unsigned _group, map<unsigned, Expression const*>& _matchGroups)
+void Pattern::setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups)
 {
+	assertThrow(0 < _group && _group < _matchGroups.size(), OptimizerException, "Invalid match group.");
 	m_matchGroup = _group;
 	m_matchGroups = &_matchGroups;
 }
@@ -127,7 +151,7 @@ bool Pattern::matches(Expression const& _expr) const
 	// based on identical ASTs, which have to be movable.
 	if (m_matchGroup)
 	{
-		if (m_matchGroups->count(m_matchGroup))
+		if ((*m_matchGroups)[m_matchGroup])
 		{
 			Expression const* firstMatch = (*m_matchGroups)[m_matchGroup];
 			assertThrow(firstMatch, OptimizerException, "Match set but to null.");
@@ -141,6 +165,21 @@ bool Pattern::matches(Expression const& _expr) const
 	return true;
 }
 
+void Pattern::appendSymbols(vector<solidity::DiscriminationTree::Symbol>& _symbols) const
+{
+	using Symbol = solidity::DiscriminationTree::Symbol;
+	if (m_kind == PatternKind::Operation)
+	{
+		_symbols.push_back(Symbol::operation(m_instruction));
+		for (Pattern const& argument: m_arguments)
+			argument.appendSymbols(_symbols);
+	}
+	else if (m_kind == PatternKind::Constant)
+		_symbols.push_back(m_data ? Symbol::constant(*m_data) : Symbol::anyConstant());
+	else
+		_symbols.push_back(Symbol::any());
+}
+
 solidity::Instruction Pattern::instruction() const
 {
 	assertThrow(m_kind == PatternKind::Operation, OptimizerException, "");
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <libevmasm/DiscriminationTree.h>
 #include <libevmasm/ExpressionClasses.h>
 #include <libevmasm/SimplificationRule.h>
 
@@ -55,10 +56,15 @@ private:
 	void addRules(std::vector<SimplificationRule<Pattern>> const& _rules);
 	void addRule(SimplificationRule<Pattern> const& _rule);
 
-	void resetMatchGroups() { m_matchGroups.clear(); }
+	void resetMatchGroups() { m_matchGroups.fill(nullptr); }
 
-	std::map<unsigned, Expression const*> m_matchGroups;
-	std::vector<SimplificationRule<Pattern>> m_rules[256];
+	MatchGroups<Expression> m_matchGroups{};
+	std::vector<SimplificationRule<Pattern>> m_rules;
+	/// Index over the patterns of m_rules.
+	solidity::DiscriminationTree m_tree;
+	/// Buffers for looking up candidates in m_tree, kept to avoid reallocations.
+	std::vector<Expression const*> m_pending;
+	std::vector<size_t> m_candidates;
 };
 
 enum class PatternKind
@@ -87,9 +93,11 @@ public:
 	/// Sets this pattern to be part of the match group with the identifier @a _group.
 	/// Inside one rule, all patterns in the same match group have to match expressions from the
 	/// same expression equivalence class.
-	void setMatchGroup(unsigned _group, std::map<unsigned, Expression const*>& _matchGroups);
+	void setMatchGroup(unsigned _group, MatchGroups<Expression>& _matchGroups);
 	unsigned matchGroup() const { return m_matchGroup; }
 	bool matches(Expression const& _expr) const;
+	/// Appends the nodes of this pattern in pre-order to @a _symbols, for DiscriminationTree.
+	void appendSymbols(std::vector<solidity::DiscriminationTree::Symbol>& _symbols) const;
 
 	std::vector<Pattern> arguments() const { return m_arguments; }
 
@@ -110,7 +118,7 @@ private:
 	std::shared_ptr<u256> m_data; ///< Only valid if m_kind is Constant
 	std::vector<Pattern> m_arguments;
 	unsigned m_matchGroup = 0;
-	std::map<unsigned, Expression const*>* m_matchGroups = nullptr;
+	MatchGroups<Expression>* m_matchGroups = nullptr;
 };
 
 }
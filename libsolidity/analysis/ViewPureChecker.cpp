@@ -117,7 +117,8 @@ private:
 bool ViewPureChecker::check()
 {
 	// The bool means "enforce view with errors".
-	map<ContractDefinition const*, bool> contracts;
+	// Kept in source order, so that the order of the reported errors does not depend on node addresses.
+	vector<pair<ContractDefinition const*, bool>> contracts;
 
 	for (auto const& node: m_ast)
 	{
@@ -125,7 +126,7 @@ bool ViewPureChecker::check()
 		solAssert(source, "");
 		bool enforceView = source->annotation().experimentalFeatures.count(ExperimentalFeature::V050);
 		for (ContractDefinition const* c: source->filteredNodes<ContractDefinition>(source->nodes()))
-			contracts[c] = enforceView;
+			contracts.emplace_back(c, enforceView);
 	}
 
 	// Check modifiers first to infer their state mutability.
@@ -38,15 +38,35 @@ using namespace dev::solidity;
 class IDDispenser
 {
 public:
-	static size_t next() { return ++instance(); }
-	static void reset() { instance() = 0; }
+	static size_t next() { return localCounter() ? ++*localCounter() : ++instance(); }
+	static void reset()
+	{
+		if (localCounter())
+			*localCounter() = 0;
+		else
+			instance() = 0;
+	}
+	static size_t reserve(size_t _count)
+	{
+		if (!localCounter())
+			return instance().fetch_add(_count);
+		size_t previous = *localCounter();
+		*localCounter() += _count;
+		return previous;
+	}
+	/// Counter used instead of the global one on the current thread, if set.
+	static size_t*& localCounter()
+	{
+		static thread_local size_t* counter = nullptr;
+		return counter;
+	}
 private:
-	static size_t& instance()
+	static atomic<size_t>& instance()
 	{
 		static IDDispenser dispenser;
 		return dispenser.id;
 	}
-	size_t id = 0;
+	atomic<size_t> id{0};
 };
 
 ASTNode::ASTNode(SourceLocation const& _location):
@@ -57,7 +77,15 @@ ASTNode::ASTNode(SourceLocation const& _location):
 
 ASTNode::~ASTNode()
 {
-	delete m_annotation;
+	destroyAnnotation(m_annotation.load());
+}
+
+void ASTNode::destroyAnnotation(ASTAnnotation* _annotation) const
+{
+	if (!m_arena)
+		delete _annotation;
+	else if (_annotation)
+		_annotation->~ASTAnnotation();
 }
 
 void ASTNode::resetID()
@@ -65,18 +93,105 @@ void ASTNode::resetID()
 	IDDispenser::reset();
 }
 
+size_t ASTNode::withLocalIDs(function<void()> const& _function)
+{
+	size_t counter = 0;
+	{
+		IDCounterScope scope(counter);
+		_function();
+	}
+	return counter;
+}
+
+ASTNode::IDCounterScope::IDCounterScope(size_t& _counter):
+	m_previousCounter(IDDispenser::localCounter())
+{
+	IDDispenser::localCounter() = &_counter;
+}
+
+ASTNode::IDCounterScope::~IDCounterScope()
+{
+	IDDispenser::localCounter() = m_previousCounter;
+}
+
+shared_ptr<ASTArena> const*& ASTNode::currentArena()
+{
+	static thread_local shared_ptr<ASTArena> const* arena = nullptr;
+	return arena;
+}
+
+ASTNode::ArenaScope::ArenaScope(shared_ptr<ASTArena> const& _arena):
+	m_previousArena(currentArena())
+{
+	if (_arena)
+		currentArena() = &_arena;
+}
+
+ASTNode::ArenaScope::~ArenaScope()
+{
+	currentArena() = m_previousArena;
+}
+
+size_t ASTNode::reserveIDs(size_t _count)
+{
+	return IDDispenser::reserve(_count);
+}
+
+namespace
+{
+
+/// Calls @a _function on all nodes in @a _sourceUnit, including the ones that are not visited.
+/// Only used on mutable source units, so the nodes are not actually const.
+void forEachNode(SourceUnit const& _sourceUnit, function<void(ASTNode&)> const& _function)
+{
+	SimpleASTVisitor visitor(
+		[&](ASTNode const& _node)
+		{
+			_function(const_cast<ASTNode&>(_node));
+			// Import aliases are not visited.
+			if (auto import = dynamic_cast<ImportDirective const*>(&_node))
+				for (auto const& alias: import->symbolAliases())
+					_function(*alias.first);
+			return true;
+		},
+		[](ASTNode const&) {}
+	);
+	_sourceUnit.accept(visitor);
+}
+
+}
+
+void ASTNode::shiftIDs(SourceUnit& _sourceUnit, size_t _offset)
+{
+	forEachNode(_sourceUnit, [&](ASTNode& _node) { _node.m_id += _offset; });
+}
+
+vector<size_t> ASTNode::nodeIDs(SourceUnit const& _sourceUnit)
+{
+	vector<size_t> ids;
+	forEachNode(_sourceUnit, [&](ASTNode& _node) { ids.push_back(_node.m_id); });
+	return ids;
+}
+
+void ASTNode::setNodeIDs(SourceUnit& _sourceUnit, vector<size_t> const& _ids)
+{
+	size_t i = 0;
+	forEachNode(_sourceUnit, [&](ASTNode& _node)
+	{
+		solAssert(i < _ids.size(), "Too few node IDs.");
+		_node.m_id = _ids[i++];
+	});
+	solAssert(i == _ids.size(), "Too many node IDs.");
+}
+
 ASTAnnotation& ASTNode::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ASTAnnotation();
-	return *m_annotation;
+	return initAnnotation<ASTAnnotation>();
 }
 
 SourceUnitAnnotation& SourceUnit::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new SourceUnitAnnotation();
-	return dynamic_cast<SourceUnitAnnotation&>(*m_annotation);
+	return initAnnotation<SourceUnitAnnotation>();
 }
 
 set<SourceUnit const*> SourceUnit::referencedSourceUnits(bool _recurse, set<SourceUnit const*> _skipList) const
@@ -98,9 +213,7 @@ set<SourceUnit const*> SourceUnit::referencedSourceUnits(bool _recurse, set<Sour
 
 ImportAnnotation& ImportDirective::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ImportAnnotation();
-	return dynamic_cast<ImportAnnotation&>(*m_annotation);
+	return initAnnotation<ImportAnnotation>();
 }
 
 TypePointer ImportDirective::type() const
@@ -150,6 +263,7 @@ FunctionDefinition const* ContractDefinition::fallbackFunction() const
 
 vector<EventDefinition const*> const& ContractDefinition::interfaceEvents() const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_interfaceEvents)
 	{
 		set<string> eventsSeen;
@@ -175,6 +289,7 @@ vector<EventDefinition const*> const& ContractDefinition::interfaceEvents() cons
 
 vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::interfaceFunctionList() const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_interfaceFunctionList)
 	{
 		set<string> signaturesSeen;
@@ -208,6 +323,7 @@ vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::inter
 
 vector<Declaration const*> const& ContractDefinition::inheritableMembers() const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_inheritableMembers)
 	{
 		set<string> memberSeen;
@@ -247,16 +363,12 @@ TypePointer ContractDefinition::type() const
 
 ContractDefinitionAnnotation& ContractDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ContractDefinitionAnnotation();
-	return dynamic_cast<ContractDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<ContractDefinitionAnnotation>();
 }
 
 TypeNameAnnotation& TypeName::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new TypeNameAnnotation();
-	return dynamic_cast<TypeNameAnnotation&>(*m_annotation);
+	return initAnnotation<TypeNameAnnotation>();
 }
 
 TypePointer StructDefinition::type() const
@@ -266,9 +378,7 @@ TypePointer StructDefinition::type() const
 
 TypeDeclarationAnnotation& StructDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new TypeDeclarationAnnotation();
-	return dynamic_cast<TypeDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<TypeDeclarationAnnotation>();
 }
 
 TypePointer EnumValue::type() const
@@ -285,9 +395,7 @@ TypePointer EnumDefinition::type() const
 
 TypeDeclarationAnnotation& EnumDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new TypeDeclarationAnnotation();
-	return dynamic_cast<TypeDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<TypeDeclarationAnnotation>();
 }
 
 ContractDefinition::ContractKind FunctionDefinition::inContractKind() const
@@ -357,9 +465,7 @@ string FunctionDefinition::fullyQualifiedName() const
 
 FunctionDefinitionAnnotation& FunctionDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new FunctionDefinitionAnnotation();
-	return dynamic_cast<FunctionDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<FunctionDefinitionAnnotation>();
 }
 
 TypePointer ModifierDefinition::type() const
@@ -369,9 +475,7 @@ TypePointer ModifierDefinition::type() const
 
 ModifierDefinitionAnnotation& ModifierDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ModifierDefinitionAnnotation();
-	return dynamic_cast<ModifierDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<ModifierDefinitionAnnotation>();
 }
 
 TypePointer EventDefinition::type() const
@@ -389,16 +493,12 @@ std::shared_ptr<FunctionType> EventDefinition::functionType(bool _internal) cons
 
 EventDefinitionAnnotation& EventDefinition::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new EventDefinitionAnnotation();
-	return dynamic_cast<EventDefinitionAnnotation&>(*m_annotation);
+	return initAnnotation<EventDefinitionAnnotation>();
 }
 
 UserDefinedTypeNameAnnotation& UserDefinedTypeName::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new UserDefinedTypeNameAnnotation();
-	return dynamic_cast<UserDefinedTypeNameAnnotation&>(*m_annotation);
+	return initAnnotation<UserDefinedTypeNameAnnotation>();
 }
 
 SourceUnit const& Scopable::sourceUnit() const
@@ -508,72 +608,52 @@ shared_ptr<FunctionType> VariableDeclaration::functionType(bool _internal) const
 
 VariableDeclarationAnnotation& VariableDeclaration::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new VariableDeclarationAnnotation();
-	return dynamic_cast<VariableDeclarationAnnotation&>(*m_annotation);
+	return initAnnotation<VariableDeclarationAnnotation>();
 }
 
 StatementAnnotation& Statement::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new StatementAnnotation();
-	return dynamic_cast<StatementAnnotation&>(*m_annotation);
+	return initAnnotation<StatementAnnotation>();
 }
 
 InlineAssemblyAnnotation& InlineAssembly::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new InlineAssemblyAnnotation();
-	return dynamic_cast<InlineAssemblyAnnotation&>(*m_annotation);
+	return initAnnotation<InlineAssemblyAnnotation>();
 }
 
 ReturnAnnotation& Return::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ReturnAnnotation();
-	return dynamic_cast<ReturnAnnotation&>(*m_annotation);
+	return initAnnotation<ReturnAnnotation>();
 }
 
 VariableDeclarationStatementAnnotation& VariableDeclarationStatement::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new VariableDeclarationStatementAnnotation();
-	return dynamic_cast<VariableDeclarationStatementAnnotation&>(*m_annotation);
+	return initAnnotation<VariableDeclarationStatementAnnotation>();
 }
 
 ExpressionAnnotation& Expression::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new ExpressionAnnotation();
-	return dynamic_cast<ExpressionAnnotation&>(*m_annotation);
+	return initAnnotation<ExpressionAnnotation>();
 }
 
 MemberAccessAnnotation& MemberAccess::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new MemberAccessAnnotation();
-	return dynamic_cast<MemberAccessAnnotation&>(*m_annotation);
+	return initAnnotation<MemberAccessAnnotation>();
 }
 
 BinaryOperationAnnotation& BinaryOperation::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new BinaryOperationAnnotation();
-	return dynamic_cast<BinaryOperationAnnotation&>(*m_annotation);
+	return initAnnotation<BinaryOperationAnnotation>();
 }
 
 FunctionCallAnnotation& FunctionCall::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new FunctionCallAnnotation();
-	return dynamic_cast<FunctionCallAnnotation&>(*m_annotation);
+	return initAnnotation<FunctionCallAnnotation>();
 }
 
 IdentifierAnnotation& Identifier::annotation() const
 {
-	if (!m_annotation)
-		m_annotation = new IdentifierAnnotation();
-	return dynamic_cast<IdentifierAnnotation&>(*m_annotation);
+	return initAnnotation<IdentifierAnnotation>();
 }
 
 bool Literal::isHexNumber() const
@@ -24,6 +24,7 @@
 
 
 #include <libsolidity/ast/ASTForward.h>
+#include <libsolidity/ast/ASTArena.h>
 #include <libsolidity/parsing/Token.h>
 #include <libsolidity/ast/Types.h>
 #include <libsolidity/ast/ASTAnnotations.h>
@@ -37,9 +38,11 @@
 
 #include <boost/noncopyable.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 
 namespace dev
 {
@@ -63,8 +66,50 @@ public:
 
 	/// @returns an identifier of this AST node that is unique for a single compilation run.
 	size_t id() const { return m_id; }
-	/// Resets the global ID counter. This invalidates all previous IDs.
+	/// Resets the current ID counter. This invalidates all previous IDs.
 	static void resetID();
+	/// Calls @a _function such that nodes created by it on the current thread receive IDs
+	/// counting from one instead of IDs from the current counter, which allows to parse sources
+	/// concurrently. @returns the number of IDs dispensed.
+	static size_t withLocalIDs(std::function<void()> const& _function);
+	/// Advances the current ID counter by @a _count and @returns its previous value.
+	static size_t reserveIDs(size_t _count);
+
+	/// While it exists, the counter of the current thread is @a _counter instead of the global
+	/// counter (or the counter of an enclosing scope), i.e. nodes created on the current thread
+	/// receive their IDs from it and resetID and reserveIDs act on it.
+	class IDCounterScope: private boost::noncopyable
+	{
+	public:
+		explicit IDCounterScope(size_t& _counter);
+		~IDCounterScope();
+	private:
+		size_t* m_previousCounter;
+	};
+
+	/// While it exists, nodes created through create() on the current thread and their
+	/// annotations are allocated from @a _arena (or the arena of an enclosing scope) instead of
+	/// being allocated one by one. A null arena leaves the arena of the current thread unchanged.
+	class ArenaScope: private boost::noncopyable
+	{
+	public:
+		explicit ArenaScope(std::shared_ptr<ASTArena> const& _arena);
+		~ArenaScope();
+	private:
+		std::shared_ptr<ASTArena> const* m_previousArena;
+	};
+
+	/// Creates a node of type T from @a _args, allocated from the arena of the current thread
+	/// if there is one (see ArenaScope).
+	template <class T, class... Args>
+	static std::shared_ptr<T> create(Args&&... _args);
+
+	/// Adds @a _offset to the IDs of all nodes in @a _sourceUnit.
+	static void shiftIDs(SourceUnit& _sourceUnit, size_t _offset);
+	/// @returns the IDs of all nodes in @a _sourceUnit in a fixed traversal order.
+	static std::vector<size_t> nodeIDs(SourceUnit const& _sourceUnit);
+	/// Sets the IDs of all nodes in @a _sourceUnit to @a _ids, given in the order of nodeIDs.
+	static void setNodeIDs(SourceUnit& _sourceUnit, std::vector<size_t> const& _ids);
 
 	virtual void accept(ASTVisitor& _visitor) = 0;
 	virtual void accept(ASTConstVisitor& _visitor) const = 0;
@@ -99,14 +144,53 @@ public:
 	///@}
 
 protected:
-	size_t const m_id = 0;
+	/// Creates the annotation of type @a T upon first request. Safe to be called concurrently
+	/// since annotations of shared nodes are queried while compiling contracts in parallel.
+	template <class T>
+	T& initAnnotation() const;
+
+	size_t m_id = 0;
 	/// Annotation - is specialised in derived classes, is created upon request (because of polymorphism).
-	mutable ASTAnnotation* m_annotation = nullptr;
+	mutable std::atomic<ASTAnnotation*> m_annotation{nullptr};
 
 private:
+	/// @returns the arena of the current thread or null (see ArenaScope).
+	static std::shared_ptr<ASTArena> const*& currentArena();
+	/// Destroys @a _annotation and releases its memory unless it was allocated from m_arena.
+	void destroyAnnotation(ASTAnnotation* _annotation) const;
+
 	SourceLocation m_location;
+	/// Arena this node and its annotation are allocated from, if any. It is kept alive by the
+	/// reference counts of the node.
+	ASTArena* m_arena = nullptr;
 };
 
+template <class T, class... Args>
+std::shared_ptr<T> ASTNode::create(Args&&... _args)
+{
+	std::shared_ptr<ASTArena> const* arena = currentArena();
+	if (!arena)
+		return std::make_shared<T>(std::forward<Args>(_args)...);
+	auto node = std::allocate_shared<T>(ASTArena::Allocator<T>(*arena), std::forward<Args>(_args)...);
+	static_cast<ASTNode&>(*node).m_arena = arena->get();
+	return node;
+}
+
+template <class T>
+T& ASTNode::initAnnotation() const
+{
+	ASTAnnotation* annotation = m_annotation.load();
+	if (!annotation)
+	{
+		ASTAnnotation* newAnnotation = m_arena ? new (m_arena->allocate(sizeof(T))) T() : new T();
+		if (m_annotation.compare_exchange_strong(annotation, newAnnotation))
+			annotation = newAnnotation;
+		else
+			destroyAnnotation(newAnnotation);
+	}
+	return dynamic_cast<T&>(*annotation);
+}
+
 template <class _T>
 std::vector<_T const*> ASTNode::filteredNodes(std::vector<ASTPointer<ASTNode>> const& _nodes)
 {
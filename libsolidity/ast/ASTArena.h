@@ -0,0 +1,90 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Memory for AST nodes and their annotations that is released in one piece.
+ */
+
+#pragma once
+
+#include <libdevcore/Arena.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Memory that AST nodes and their annotations are placed into consecutively (see
+ * ASTNode::ArenaScope). Nothing is freed before the arena itself is destroyed, which happens
+ * once the last node allocated from it is destroyed.
+ * Allocating is thread-safe since annotations are created on demand while contracts are
+ * compiled in parallel.
+ */
+class ASTArena: boost::noncopyable
+{
+public:
+	/// @returns uninitialised memory of @a _size bytes that is suitably aligned for any object.
+	void* allocate(size_t _size)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_memory.allocate((_size + sizeof(Block) - 1) / sizeof(Block));
+	}
+
+	/// Allocator for std::allocate_shared that places the object together with its reference
+	/// counts into @a _arena and keeps the arena alive as long as the object exists.
+	template <class T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+
+		explicit Allocator(std::shared_ptr<ASTArena> _arena): m_arena(std::move(_arena)) {}
+		template <class U>
+		Allocator(Allocator<U> const& _other): m_arena(_other.m_arena) {}
+
+		T* allocate(size_t _count) { return static_cast<T*>(m_arena->allocate(_count * sizeof(T))); }
+		/// The memory is only released together with the arena.
+		void deallocate(T*, size_t) {}
+
+		template <class U>
+		bool operator==(Allocator<U> const& _other) const { return m_arena == _other.m_arena; }
+		template <class U>
+		bool operator!=(Allocator<U> const& _other) const { return m_arena != _other.m_arena; }
+
+	private:
+		template <class U> friend class Allocator;
+		std::shared_ptr<ASTArena> m_arena;
+	};
+
+private:
+	using Block = std::aligned_storage<alignof(std::max_align_t), alignof(std::max_align_t)>::type;
+
+	std::mutex m_mutex;
+	/// Chunks of 16 KiB, small enough for arenas of short sources.
+	Arena<Block> m_memory{0x4000 / sizeof(Block)};
+};
+
+}
+}
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <ostream>
 #include <stack>
 #include <libsolidity/ast/ASTVisitor.h>
@@ -142,14 +143,19 @@ private:
 		return _node.id();
 	}
 	template<class Container>
-	static Json::Value getContainerIds(Container const& container)
+	static Json::Value getContainerIds(Container const& container, bool _order = false)
 	{
-		Json::Value tmp(Json::arrayValue);
+		std::vector<int> ids;
 		for (auto const& element: container)
 		{
 			solAssert(element, "");
-			tmp.append(nodeId(*element));
+			ids.push_back(nodeId(*element));
 		}
+		if (_order)
+			std::sort(ids.begin(), ids.end());
+		Json::Value tmp(Json::arrayValue);
+		for (int id: ids)
+			tmp.append(id);
 		return tmp;
 	}
 	static Json::Value typePointerToJson(TypePointer _tp);
@@ -0,0 +1,986 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Compact binary serialisation of parsed source units.
+ */
+
+#include <libsolidity/ast/ASTSnapshot.h>
+
+#include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTVisitor.h>
+#include <libsolidity/inlineasm/AsmData.h>
+#include <libsolidity/inlineasm/AsmParser.h>
+#include <libsolidity/interface/ErrorReporter.h>
+#include <libsolidity/parsing/Scanner.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+/// Format version, has to be changed whenever the encoding of any node changes.
+static uint8_t const c_snapshotVersion = 1;
+static char const c_snapshotMagic[] = "solAST";
+
+DEV_SIMPLE_EXCEPTION(InvalidSnapshot);
+
+enum class NodeKind: uint8_t
+{
+	Null,
+	SourceUnit,
+	PragmaDirective,
+	ImportDirective,
+	ContractDefinition,
+	InheritanceSpecifier,
+	UsingForDirective,
+	StructDefinition,
+	EnumDefinition,
+	EnumValue,
+	ParameterList,
+	FunctionDefinition,
+	VariableDeclaration,
+	ModifierDefinition,
+	ModifierInvocation,
+	EventDefinition,
+	ElementaryTypeName,
+	UserDefinedTypeName,
+	FunctionTypeName,
+	Mapping,
+	ArrayTypeName,
+	InlineAssembly,
+	Block,
+	PlaceholderStatement,
+	IfStatement,
+	WhileStatement,
+	ForStatement,
+	Continue,
+	Break,
+	Return,
+	Throw,
+	EmitStatement,
+	VariableDeclarationStatement,
+	ExpressionStatement,
+	Conditional,
+	Assignment,
+	TupleExpression,
+	UnaryOperation,
+	BinaryOperation,
+	FunctionCall,
+	NewExpression,
+	MemberAccess,
+	IndexAccess,
+	Identifier,
+	ElementaryTypeNameExpression,
+	Literal
+};
+
+/**
+ * Writes the nodes in depth-first order. Every node starts with its kind and its source location,
+ * followed by its own data and its children in the order of the constructor arguments.
+ * Integers are stored as LEB128, strings with their length plus one in front.
+ */
+class SnapshotWriter: private ASTConstVisitor
+{
+public:
+	bytes write(SourceUnit const& _sourceUnit, size_t _firstID, size_t _idCount)
+	{
+		m_data.clear();
+		m_data += bytes(begin(c_snapshotMagic), end(c_snapshotMagic) - 1);
+		m_data.push_back(c_snapshotVersion);
+		writeUnsigned(_idCount);
+		vector<size_t> ids = ASTNode::nodeIDs(_sourceUnit);
+		writeUnsigned(ids.size());
+		for (size_t id: ids)
+		{
+			solAssert(_firstID < id && id <= _firstID + _idCount, "Node ID out of range.");
+			writeUnsigned(id - _firstID);
+		}
+		writeNode(&_sourceUnit);
+		return std::move(m_data);
+	}
+
+private:
+	void writeUnsigned(size_t _value)
+	{
+		for (; _value >= 0x80; _value >>= 7)
+			m_data.push_back(uint8_t(_value | 0x80));
+		m_data.push_back(uint8_t(_value));
+	}
+	void writeBool(bool _value) { m_data.push_back(_value ? 1 : 0); }
+	void writeString(string const& _value)
+	{
+		// Zero is reserved for null pointers.
+		writeUnsigned(_value.size() + 1);
+		m_data += bytes(_value.begin(), _value.end());
+	}
+	void writeString(ASTPointer<ASTString> const& _value)
+	{
+		if (_value)
+			writeString(*_value);
+		else
+			writeUnsigned(0);
+	}
+	void writeStrings(vector<ASTString> const& _values)
+	{
+		writeUnsigned(_values.size());
+		for (auto const& value: _values)
+			writeString(value);
+	}
+	void writeKind(NodeKind _kind, ASTNode const& _node)
+	{
+		m_data.push_back(uint8_t(_kind));
+		// Locations may be empty (-1), so they are shifted by one.
+		writeUnsigned(_node.location().start + 1);
+		writeUnsigned(_node.location().end + 1);
+	}
+	void writeToken(ElementaryTypeNameToken const& _token)
+	{
+		writeUnsigned(_token.token());
+		writeUnsigned(_token.firstNumber());
+		writeUnsigned(_token.secondNumber());
+	}
+	void writeNode(ASTNode const* _node)
+	{
+		if (_node)
+			_node->accept(*this);
+		else
+			m_data.push_back(uint8_t(NodeKind::Null));
+	}
+	template <class T>
+	void writeNodes(vector<ASTPointer<T>> const& _nodes)
+	{
+		writeUnsigned(_nodes.size());
+		for (auto const& node: _nodes)
+			writeNode(node.get());
+	}
+
+	virtual bool visit(SourceUnit const& _node) override
+	{
+		writeKind(NodeKind::SourceUnit, _node);
+		writeNodes(_node.nodes());
+		return false;
+	}
+	virtual bool visit(PragmaDirective const& _node) override
+	{
+		writeKind(NodeKind::PragmaDirective, _node);
+		writeUnsigned(_node.tokens().size());
+		for (Token::Value token: _node.tokens())
+			writeUnsigned(token);
+		writeStrings(_node.literals());
+		return false;
+	}
+	virtual bool visit(ImportDirective const& _node) override
+	{
+		writeKind(NodeKind::ImportDirective, _node);
+		writeString(_node.path());
+		writeString(_node.name());
+		writeUnsigned(_node.symbolAliases().size());
+		for (auto const& alias: _node.symbolAliases())
+		{
+			writeNode(alias.first.get());
+			writeString(alias.second);
+		}
+		return false;
+	}
+	virtual bool visit(ContractDefinition const& _node) override
+	{
+		writeKind(NodeKind::ContractDefinition, _node);
+		writeString(_node.name());
+		writeString(_node.documentation());
+		writeNodes(_node.baseContracts());
+		writeNodes(_node.subNodes());
+		writeUnsigned(unsigned(_node.contractKind()));
+		return false;
+	}
+	virtual bool visit(InheritanceSpecifier const& _node) override
+	{
+		writeKind(NodeKind::InheritanceSpecifier, _node);
+		writeNode(&_node.name());
+		writeNodes(_node.arguments());
+		return false;
+	}
+	virtual bool visit(UsingForDirective const& _node) override
+	{
+		writeKind(NodeKind::UsingForDirective, _node);
+		writeNode(&_node.libraryName());
+		writeNode(_node.typeName());
+		return false;
+	}
+	virtual bool visit(StructDefinition const& _node) override
+	{
+		writeKind(NodeKind::StructDefinition, _node);
+		writeString(_node.name());
+		writeNodes(_node.members());
+		return false;
+	}
+	virtual bool visit(EnumDefinition const& _node) override
+	{
+		writeKind(NodeKind::EnumDefinition, _node);
+		writeString(_node.name());
+		writeNodes(_node.members());
+		return false;
+	}
+	virtual bool visit(EnumValue const& _node) override
+	{
+		writeKind(NodeKind::EnumValue, _node);
+		writeString(_node.name());
+		return false;
+	}
+	virtual bool visit(ParameterList const& _node) override
+	{
+		writeKind(NodeKind::ParameterList, _node);
+		writeNodes(_node.parameters());
+		return false;
+	}
+	virtual bool visit(FunctionDefinition const& _node) override
+	{
+		writeKind(NodeKind::FunctionDefinition, _node);
+		writeString(_node.name());
+		writeUnsigned(_node.noVisibilitySpecified() ? unsigned(Declaration::Visibility::Default) : unsigned(_node.visibility()));
+		writeUnsigned(unsigned(_node.stateMutability()));
+		writeBool(_node.isConstructor());
+		writeString(_node.documentation());
+		writeNode(&_node.parameterList());
+		writeNodes(_node.modifiers());
+		writeNode(_node.returnParameterList().get());
+		writeNode(_node.isImplemented() ? &_node.body() : nullptr);
+		return false;
+	}
+	virtual bool visit(VariableDeclaration const& _node) override
+	{
+		writeKind(NodeKind::VariableDeclaration, _node);
+		writeNode(_node.typeName());
+		writeString(_node.name());
+		writeNode(_node.value().get());
+		writeUnsigned(_node.noVisibilitySpecified() ? unsigned(Declaration::Visibility::Default) : unsigned(_node.visibility()));
+		writeBool(_node.isStateVariable());
+		writeBool(_node.isIndexed());
+		writeBool(_node.isConstant());
+		writeUnsigned(unsigned(_node.referenceLocation()));
+		return false;
+	}
+	virtual bool visit(ModifierDefinition const& _node) override
+	{
+		writeKind(NodeKind::ModifierDefinition, _node);
+		writeString(_node.name());
+		writeString(_node.documentation());
+		writeNode(&_node.parameterList());
+		writeNode(&_node.body());
+		return false;
+	}
+	virtual bool visit(ModifierInvocation const& _node) override
+	{
+		writeKind(NodeKind::ModifierInvocation, _node);
+		writeNode(_node.name().get());
+		writeNodes(_node.arguments());
+		return false;
+	}
+	virtual bool visit(EventDefinition const& _node) override
+	{
+		writeKind(NodeKind::EventDefinition, _node);
+		writeString(_node.name());
+		writeString(_node.documentation());
+		writeNode(&_node.parameterList());
+		writeBool(_node.isAnonymous());
+		return false;
+	}
+	virtual bool visit(ElementaryTypeName const& _node) override
+	{
+		writeKind(NodeKind::ElementaryTypeName, _node);
+		writeToken(_node.typeName());
+		return false;
+	}
+	virtual bool visit(UserDefinedTypeName const& _node) override
+	{
+		writeKind(NodeKind::UserDefinedTypeName, _node);
+		writeStrings(_node.namePath());
+		return false;
+	}
+	virtual bool visit(FunctionTypeName const& _node) override
+	{
+		writeKind(NodeKind::FunctionTypeName, _node);
+		writeNode(_node.parameterTypeList().get());
+		writeNode(_node.returnParameterTypeList().get());
+		writeUnsigned(unsigned(_node.visibility()));
+		writeUnsigned(unsigned(_node.stateMutability()));
+		return false;
+	}
+	virtual bool visit(Mapping const& _node) override
+	{
+		writeKind(NodeKind::Mapping, _node);
+		writeNode(&_node.keyType());
+		writeNode(&_node.valueType());
+		return false;
+	}
+	virtual bool visit(ArrayTypeName const& _node) override
+	{
+		writeKind(NodeKind::ArrayTypeName, _node);
+		writeNode(&_node.baseType());
+		writeNode(_node.length());
+		return false;
+	}
+	virtual bool visit(InlineAssembly const& _node) override
+	{
+		writeKind(NodeKind::InlineAssembly, _node);
+		writeString(_node.documentation());
+		// Only the position of the block is stored, it is parsed again when reading.
+		writeUnsigned(_node.operations().location.start);
+		return false;
+	}
+	virtual bool visit(Block const& _node) override
+	{
+		writeKind(NodeKind::Block, _node);
+		writeString(_node.documentation());
+		writeNodes(_node.statements());
+		return false;
+	}
+	virtual bool visit(PlaceholderStatement const& _node) override
+	{
+		writeKind(NodeKind::PlaceholderStatement, _node);
+		writeString(_node.documentation());
+		return false;
+	}
+	virtual bool visit(IfStatement const& _node) override
+	{
+		writeKind(NodeKind::IfStatement, _node);
+		writeString(_node.documentation());
+		writeNode(&_node.condition());
+		writeNode(&_node.trueStatement());
+		writeNode(_node.falseStatement());
+		return false;
+	}
+	virtual bool visit(WhileStatement const& _node) override
+	{
+		writeKind(NodeKind::WhileStatement, _node);
+		writeString(_node.documentation());
+		writeNode(&_node.condition());
+		writeNode(&_node.body());
+		writeBool(_node.isDoWhile());
+		return false;
+	}
+	virtual bool visit(ForStatement const& _node) override
+	{
+		writeKind(NodeKind::ForStatement, _node);
+		writeString(_node.documentation());
+		writeNode(_node.initializationExpression());
+		writeNode(_node.condition());
+		writeNode(_node.loopExpression());
+		writeNode(&_node.body());
+		return false;
+	}
+	virtual bool visit(Continue const& _node) override
+	{
+		writeKind(NodeKind::Continue, _node);
+		writeString(_node.documentation());
+		return false;
+	}
+	virtual bool visit(Break const& _node) override
+	{
+		writeKind(NodeKind::Break, _node);
+		writeString(_node.documentation());
+		return false;
+	}
+	virtual bool visit(Return const& _node) override
+	{
+		writeKind(NodeKind::Return, _node);
+		writeString(_node.documentation());
+		writeNode(_node.expression());
+		return false;
+	}
+	virtual bool visit(Throw const& _node) override
+	{
+		writeKind(NodeKind::Throw, _node);
+		writeString(_node.documentation());
+		return false;
+	}
+	virtual bool visit(EmitStatement const& _node) override
+	{
+		writeKind(NodeKind::EmitStatement, _node);
+		writeString(_node.documentation());
+		writeNode(&_node.eventCall());
+		return false;
+	}
+	virtual bool visit(VariableDeclarationStatement const& _node) override
+	{
+		writeKind(NodeKind::VariableDeclarationStatement, _node);
+		writeString(_node.documentation());
+		writeNodes(_node.declarations());
+		writeNode(_node.initialValue());
+		return false;
+	}
+	virtual bool visit(ExpressionStatement const& _node) override
+	{
+		writeKind(NodeKind::ExpressionStatement, _node);
+		writeString(_node.documentation());
+		writeNode(&_node.expression());
+		return false;
+	}
+	virtual bool visit(Conditional const& _node) override
+	{
+		writeKind(NodeKind::Conditional, _node);
+		writeNode(&_node.condition());
+		writeNode(&_node.trueExpression());
+		writeNode(&_node.falseExpression());
+		return false;
+	}
+	virtual bool visit(Assignment const& _node) override
+	{
+		writeKind(NodeKind::Assignment, _node);
+		writeNode(&_node.leftHandSide());
+		writeUnsigned(_node.assignmentOperator());
+		writeNode(&_node.rightHandSide());
+		return false;
+	}
+	virtual bool visit(TupleExpression const& _node) override
+	{
+		writeKind(NodeKind::TupleExpression, _node);
+		writeNodes(_node.components());
+		writeBool(_node.isInlineArray());
+		return false;
+	}
+	virtual bool visit(UnaryOperation const& _node) override
+	{
+		writeKind(NodeKind::UnaryOperation, _node);
+		writeUnsigned(_node.getOperator());
+		writeNode(&_node.subExpression());
+		writeBool(_node.isPrefixOperation());
+		return false;
+	}
+	virtual bool visit(BinaryOperation const& _node) override
+	{
+		writeKind(NodeKind::BinaryOperation, _node);
+		writeNode(&_node.leftExpression());
+		writeUnsigned(_node.getOperator());
+		writeNode(&_node.rightExpression());
+		return false;
+	}
+	virtual bool visit(FunctionCall const& _node) override
+	{
+		writeKind(NodeKind::FunctionCall, _node);
+		writeNode(&_node.expression());
+		writeNodes(_node.arguments());
+		writeUnsigned(_node.names().size());
+		for (auto const& name: _node.names())
+			writeString(name);
+		return false;
+	}
+	virtual bool visit(NewExpression const& _node) override
+	{
+		writeKind(NodeKind::NewExpression, _node);
+		writeNode(&_node.typeName());
+		return false;
+	}
+	virtual bool visit(MemberAccess const& _node) override
+	{
+		writeKind(NodeKind::MemberAccess, _node);
+		writeNode(&_node.expression());
+		writeString(_node.memberName());
+		return false;
+	}
+	virtual bool visit(IndexAccess const& _node) override
+	{
+		writeKind(NodeKind::IndexAccess, _node);
+		writeNode(&_node.baseExpression());
+		writeNode(_node.indexExpression());
+		return false;
+	}
+	virtual bool visit(Identifier const& _node) override
+	{
+		writeKind(NodeKind::Identifier, _node);
+		writeString(_node.name());
+		return false;
+	}
+	virtual bool visit(ElementaryTypeNameExpression const& _node) override
+	{
+		writeKind(NodeKind::ElementaryTypeNameExpression, _node);
+		writeToken(_node.typeName());
+		return false;
+	}
+	virtual bool visit(Literal const& _node) override
+	{
+		writeKind(NodeKind::Literal, _node);
+		writeUnsigned(_node.token());
+		writeString(_node.value());
+		writeUnsigned(unsigned(_node.subDenomination()));
+		return false;
+	}
+
+	bytes m_data;
+};
+
+/**
+ * Reads the format written by SnapshotWriter. Throws InvalidSnapshot on malformed input.
+ */
+class SnapshotReader
+{
+public:
+	SnapshotReader(bytesConstRef _data, shared_ptr<Scanner> const& _scanner):
+		m_data(_data), m_scanner(_scanner)
+	{}
+
+	pair<ASTPointer<SourceUnit>, size_t> read()
+	{
+		for (char c: string(c_snapshotMagic))
+			if (readByte() != uint8_t(c))
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		if (readByte() != c_snapshotVersion)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		size_t idCount = readUnsigned();
+		vector<size_t> ids(readCount());
+		for (size_t& id: ids)
+		{
+			id = readUnsigned();
+			if (id == 0 || id > idCount)
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		}
+		auto sourceUnit = readNode<SourceUnit>();
+		if (!sourceUnit || m_position != m_data.size())
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		// The reader creates exactly the nodes the IDs were collected from, but check anyway
+		// since the snapshot could have been modified.
+		if (ASTNode::nodeIDs(*sourceUnit).size() != ids.size())
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		ASTNode::setNodeIDs(*sourceUnit, ids);
+		return make_pair(sourceUnit, idCount);
+	}
+
+private:
+	uint8_t readByte()
+	{
+		if (m_position >= m_data.size())
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return m_data[m_position++];
+	}
+	size_t readUnsigned()
+	{
+		size_t value = 0;
+		for (unsigned shift = 0; ; shift += 7)
+		{
+			if (shift >= 64)
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+			uint8_t byte = readByte();
+			value |= size_t(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+	}
+	/// Reads the number of elements of a list, which cannot exceed the number of remaining bytes.
+	size_t readCount()
+	{
+		size_t count = readUnsigned();
+		if (count > m_data.size() - m_position)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return count;
+	}
+	bool readBool() { return readByte() != 0; }
+	string readBytes(size_t _length)
+	{
+		if (_length > m_data.size() - m_position)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		string value(reinterpret_cast<char const*>(m_data.data() + m_position), _length);
+		m_position += _length;
+		return value;
+	}
+	ASTPointer<ASTString> readStringPointer()
+	{
+		size_t length = readUnsigned();
+		if (length == 0)
+			return nullptr;
+		return make_shared<ASTString>(readBytes(length - 1));
+	}
+	ASTString readString()
+	{
+		size_t length = readUnsigned();
+		if (length == 0)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return readBytes(length - 1);
+	}
+	ASTPointer<ASTString> readName() { return make_shared<ASTString>(readString()); }
+	vector<ASTString> readStrings()
+	{
+		vector<ASTString> values(readCount());
+		for (auto& value: values)
+			value = readString();
+		return values;
+	}
+	Token::Value readToken()
+	{
+		size_t token = readUnsigned();
+		if (token >= Token::NUM_TOKENS)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return Token::Value(token);
+	}
+	template <class T>
+	T readEnum(T _last)
+	{
+		size_t value = readUnsigned();
+		if (value > size_t(_last))
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return T(value);
+	}
+	ElementaryTypeNameToken readElementaryToken()
+	{
+		Token::Value token = readToken();
+		unsigned first = readUnsigned();
+		unsigned second = readUnsigned();
+		if (!Token::isElementaryTypeName(token))
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return ElementaryTypeNameToken(token, first, second);
+	}
+	SourceLocation readLocation()
+	{
+		int start = int(readUnsigned()) - 1;
+		int end = int(readUnsigned()) - 1;
+		return SourceLocation(start, end, m_scanner->sourceID());
+	}
+
+	template <class T>
+	ASTPointer<T> readNode()
+	{
+		ASTPointer<ASTNode> node = readAnyNode();
+		if (!node)
+			return nullptr;
+		auto result = dynamic_pointer_cast<T>(node);
+		if (!result)
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return result;
+	}
+	template <class T>
+	vector<ASTPointer<T>> readNodes()
+	{
+		vector<ASTPointer<T>> nodes(readCount());
+		for (auto& node: nodes)
+			node = readNode<T>();
+		return nodes;
+	}
+	shared_ptr<assembly::Block> readInlineAssembly(size_t _offset)
+	{
+		ErrorList errors;
+		ErrorReporter errorReporter(errors);
+		m_scanner->setPosition(_offset);
+		auto block = assembly::Parser(errorReporter).parse(m_scanner, true);
+		if (!block || !errors.empty())
+			BOOST_THROW_EXCEPTION(InvalidSnapshot());
+		return block;
+	}
+
+	ASTPointer<ASTNode> readAnyNode()
+	{
+		// Arguments are read into local variables first since the evaluation order of
+		// function arguments is unspecified.
+		NodeKind kind = readEnum(NodeKind::Literal);
+		if (kind == NodeKind::Null)
+			return nullptr;
+		SourceLocation location = readLocation();
+		switch (kind)
+		{
+		case NodeKind::Null:
+			break;
+		case NodeKind::SourceUnit:
+			return ASTNode::create<SourceUnit>(location, readNodes<ASTNode>());
+		case NodeKind::PragmaDirective:
+		{
+			vector<Token::Value> tokens(readCount());
+			for (auto& token: tokens)
+				token = readToken();
+			return ASTNode::create<PragmaDirective>(location, tokens, readStrings());
+		}
+		case NodeKind::ImportDirective:
+		{
+			auto path = readName();
+			auto unitAlias = readName();
+			vector<pair<ASTPointer<Identifier>, ASTPointer<ASTString>>> symbolAliases(readCount());
+			for (auto& alias: symbolAliases)
+			{
+				alias.first = readNode<Identifier>();
+				alias.second = readStringPointer();
+			}
+			return ASTNode::create<ImportDirective>(location, path, unitAlias, std::move(symbolAliases));
+		}
+		case NodeKind::ContractDefinition:
+		{
+			auto name = readName();
+			auto documentation = readStringPointer();
+			auto baseContracts = readNodes<InheritanceSpecifier>();
+			auto subNodes = readNodes<ASTNode>();
+			auto contractKind = readEnum(ContractDefinition::ContractKind::Library);
+			return ASTNode::create<ContractDefinition>(location, name, documentation, baseContracts, subNodes, contractKind);
+		}
+		case NodeKind::InheritanceSpecifier:
+		{
+			auto baseName = readNode<UserDefinedTypeName>();
+			return ASTNode::create<InheritanceSpecifier>(location, baseName, readNodes<Expression>());
+		}
+		case NodeKind::UsingForDirective:
+		{
+			auto libraryName = readNode<UserDefinedTypeName>();
+			return ASTNode::create<UsingForDirective>(location, libraryName, readNode<TypeName>());
+		}
+		case NodeKind::StructDefinition:
+		{
+			auto name = readName();
+			return ASTNode::create<StructDefinition>(location, name, readNodes<VariableDeclaration>());
+		}
+		case NodeKind::EnumDefinition:
+		{
+			auto name = readName();
+			return ASTNode::create<EnumDefinition>(location, name, readNodes<EnumValue>());
+		}
+		case NodeKind::EnumValue:
+			return ASTNode::create<EnumValue>(location, readName());
+		case NodeKind::ParameterList:
+			return ASTNode::create<ParameterList>(location, readNodes<VariableDeclaration>());
+		case NodeKind::FunctionDefinition:
+		{
+			auto name = readName();
+			auto visibility = readEnum(Declaration::Visibility::External);
+			auto stateMutability = readEnum(StateMutability::Payable);
+			bool isConstructor = readBool();
+			auto documentation = readStringPointer();
+			auto parameters = readNode<ParameterList>();
+			auto modifiers = readNodes<ModifierInvocation>();
+			auto returnParameters = readNode<ParameterList>();
+			auto body = readNode<Block>();
+			return ASTNode::create<FunctionDefinition>(
+				location, name, visibility, stateMutability, isConstructor, documentation,
+				parameters, modifiers, returnParameters, body
+			);
+		}
+		case NodeKind::VariableDeclaration:
+		{
+			auto typeName = readNode<TypeName>();
+			auto name = readName();
+			auto value = readNode<Expression>();
+			auto visibility = readEnum(Declaration::Visibility::External);
+			bool isStateVariable = readBool();
+			bool isIndexed = readBool();
+			bool isConstant = readBool();
+			auto referenceLocation = readEnum(VariableDeclaration::Location::Memory);
+			return ASTNode::create<VariableDeclaration>(
+				location, typeName, name, value, visibility,
+				isStateVariable, isIndexed, isConstant, referenceLocation
+			);
+		}
+		case NodeKind::ModifierDefinition:
+		{
+			auto name = readName();
+			auto documentation = readStringPointer();
+			auto parameters = readNode<ParameterList>();
+			return ASTNode::create<ModifierDefinition>(location, name, documentation, parameters, readNode<Block>());
+		}
+		case NodeKind::ModifierInvocation:
+		{
+			auto name = readNode<Identifier>();
+			return ASTNode::create<ModifierInvocation>(location, name, readNodes<Expression>());
+		}
+		case NodeKind::EventDefinition:
+		{
+			auto name = readName();
+			auto documentation = readStringPointer();
+			auto parameters = readNode<ParameterList>();
+			return ASTNode::create<EventDefinition>(location, name, documentation, parameters, readBool());
+		}
+		case NodeKind::ElementaryTypeName:
+			return ASTNode::create<ElementaryTypeName>(location, readElementaryToken());
+		case NodeKind::UserDefinedTypeName:
+			return ASTNode::create<UserDefinedTypeName>(location, readStrings());
+		case NodeKind::FunctionTypeName:
+		{
+			auto parameterTypes = readNode<ParameterList>();
+			auto returnTypes = readNode<ParameterList>();
+			auto visibility = readEnum(Declaration::Visibility::External);
+			auto stateMutability = readEnum(StateMutability::Payable);
+			return ASTNode::create<FunctionTypeName>(location, parameterTypes, returnTypes, visibility, stateMutability);
+		}
+		case NodeKind::Mapping:
+		{
+			auto keyType = readNode<ElementaryTypeName>();
+			return ASTNode::create<Mapping>(location, keyType, readNode<TypeName>());
+		}
+		case NodeKind::ArrayTypeName:
+		{
+			auto baseType = readNode<TypeName>();
+			return ASTNode::create<ArrayTypeName>(location, baseType, readNode<Expression>());
+		}
+		case NodeKind::InlineAssembly:
+		{
+			auto documentation = readStringPointer();
+			return ASTNode::create<InlineAssembly>(location, documentation, readInlineAssembly(readUnsigned()));
+		}
+		case NodeKind::Block:
+		{
+			auto documentation = readStringPointer();
+			return ASTNode::create<Block>(location, documentation, readNodes<Statement>());
+		}
+		case NodeKind::PlaceholderStatement:
+			return ASTNode::create<PlaceholderStatement>(location, readStringPointer());
+		case NodeKind::IfStatement:
+		{
+			auto documentation = readStringPointer();
+			auto condition = readNode<Expression>();
+			auto trueBody = readNode<Statement>();
+			auto falseBody = readNode<Statement>();
+			return ASTNode::create<IfStatement>(location, documentation, condition, trueBody, falseBody);
+		}
+		case NodeKind::WhileStatement:
+		{
+			auto documentation = readStringPointer();
+			auto condition = readNode<Expression>();
+			auto body = readNode<Statement>();
+			return ASTNode::create<WhileStatement>(location, documentation, condition, body, readBool());
+		}
+		case NodeKind::ForStatement:
+		{
+			auto documentation = readStringPointer();
+			auto initExpression = readNode<Statement>();
+			auto condition = readNode<Expression>();
+			auto loopExpression = readNode<ExpressionStatement>();
+			auto body = readNode<Statement>();
+			return ASTNode::create<ForStatement>(location, documentation, initExpression, condition, loopExpression, body);
+		}
+		case NodeKind::Continue:
+			return ASTNode::create<Continue>(location, readStringPointer());
+		case NodeKind::Break:
+			return ASTNode::create<Break>(location, readStringPointer());
+		case NodeKind::Return:
+		{
+			auto documentation = readStringPointer();
+			return ASTNode::create<Return>(location, documentation, readNode<Expression>());
+		}
+		case NodeKind::Throw:
+			return ASTNode::create<Throw>(location, readStringPointer());
+		case NodeKind::EmitStatement:
+		{
+			auto documentation = readStringPointer();
+			return ASTNode::create<EmitStatement>(location, documentation, readNode<FunctionCall>());
+		}
+		case NodeKind::VariableDeclarationStatement:
+		{
+			auto documentation = readStringPointer();
+			auto variables = readNodes<VariableDeclaration>();
+			return ASTNode::create<VariableDeclarationStatement>(location, documentation, variables, readNode<Expression>());
+		}
+		case NodeKind::ExpressionStatement:
+		{
+			auto documentation = readStringPointer();
+			return ASTNode::create<ExpressionStatement>(location, documentation, readNode<Expression>());
+		}
+		case NodeKind::Conditional:
+		{
+			auto condition = readNode<Expression>();
+			auto trueExpression = readNode<Expression>();
+			auto falseExpression = readNode<Expression>();
+			return ASTNode::create<Conditional>(location, condition, trueExpression, falseExpression);
+		}
+		case NodeKind::Assignment:
+		{
+			auto leftHandSide = readNode<Expression>();
+			Token::Value assignmentOperator = readToken();
+			if (!Token::isAssignmentOp(assignmentOperator))
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+			return ASTNode::create<Assignment>(location, leftHandSide, assignmentOperator, readNode<Expression>());
+		}
+		case NodeKind::TupleExpression:
+		{
+			auto components = readNodes<Expression>();
+			return ASTNode::create<TupleExpression>(location, components, readBool());
+		}
+		case NodeKind::UnaryOperation:
+		{
+			Token::Value unaryOperator = readToken();
+			if (!Token::isUnaryOp(unaryOperator))
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+			auto subExpression = readNode<Expression>();
+			return ASTNode::create<UnaryOperation>(location, unaryOperator, subExpression, readBool());
+		}
+		case NodeKind::BinaryOperation:
+		{
+			auto left = readNode<Expression>();
+			Token::Value binaryOperator = readToken();
+			if (!Token::isBinaryOp(binaryOperator) && !Token::isCompareOp(binaryOperator))
+				BOOST_THROW_EXCEPTION(InvalidSnapshot());
+			return ASTNode::create<BinaryOperation>(location, left, binaryOperator, readNode<Expression>());
+		}
+		case NodeKind::FunctionCall:
+		{
+			auto expression = readNode<Expression>();
+			auto arguments = readNodes<Expression>();
+			vector<ASTPointer<ASTString>> names(readCount());
+			for (auto& name: names)
+				name = readName();
+			return ASTNode::create<FunctionCall>(location, expression, arguments, names);
+		}
+		case NodeKind::NewExpression:
+			return ASTNode::create<NewExpression>(location, readNode<TypeName>());
+		case NodeKind::MemberAccess:
+		{
+			auto expression = readNode<Expression>();
+			return ASTNode::create<MemberAccess>(location, expression, readName());
+		}
+		case NodeKind::IndexAccess:
+		{
+			auto base = readNode<Expression>();
+			return ASTNode::create<IndexAccess>(location, base, readNode<Expression>());
+		}
+		case NodeKind::Identifier:
+			return ASTNode::create<Identifier>(location, readName());
+		case NodeKind::ElementaryTypeNameExpression:
+			return ASTNode::create<ElementaryTypeNameExpression>(location, readElementaryToken());
+		case NodeKind::Literal:
+		{
+			Token::Value token = readToken();
+			auto value = readName();
+			auto subDenomination = Literal::SubDenomination(readToken());
+			return ASTNode::create<Literal>(location, token, value, subDenomination);
+		}
+		}
+		BOOST_THROW_EXCEPTION(InvalidSnapshot());
+	}
+
+	bytesConstRef m_data;
+	size_t m_position = 0;
+	shared_ptr<Scanner> m_scanner;
+};
+
+}
+
+bytes ASTSnapshot::serialise(SourceUnit const& _sourceUnit, size_t _firstID, size_t _idCount)
+{
+	return SnapshotWriter().write(_sourceUnit, _firstID, _idCount);
+}
+
+pair<ASTPointer<SourceUnit>, size_t> ASTSnapshot::deserialise(
+	bytesConstRef _snapshot,
+	shared_ptr<Scanner> const& _scanner
+)
+{
+	try
+	{
+		pair<ASTPointer<SourceUnit>, size_t> result;
+		// The IDs the nodes receive on construction are replaced by the stored ones.
+		ASTNode::withLocalIDs([&]() { result = SnapshotReader(_snapshot, _scanner).read(); });
+		return result;
+	}
+	catch (Exception const&)
+	{
+		// Also catches failed assertions in the AST constructors.
+		return make_pair(nullptr, 0);
+	}
+}
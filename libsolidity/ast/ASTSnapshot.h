@@ -0,0 +1,62 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Compact binary serialisation of parsed source units.
+ */
+
+#pragma once
+
+#include <libsolidity/ast/ASTForward.h>
+
+#include <libdevcore/Common.h>
+
+#include <memory>
+
+namespace dev
+{
+namespace solidity
+{
+
+class Scanner;
+
+/**
+ * Binary snapshot of a source unit as produced by the parser, i.e. without any annotations.
+ * It contains all nodes with their source locations, literals and documentation in
+ * depth-first order and only refers to offsets within itself, so it can be read directly
+ * from a memory-mapped file.
+ * Inline assembly blocks are not stored but parsed again from the source code.
+ */
+class ASTSnapshot
+{
+public:
+	/// @returns the snapshot of @a _sourceUnit. The node IDs are stored relative to @a _firstID,
+	/// @a _idCount is the number of IDs that were used while parsing the source.
+	static bytes serialise(SourceUnit const& _sourceUnit, size_t _firstID, size_t _idCount);
+	/// Rebuilds the source unit from @a _snapshot. The nodes receive IDs counting from one
+	/// (see ASTNode::shiftIDs) and the source locations refer to the source of @a _scanner,
+	/// which has to be the source the snapshot was created from.
+	/// @returns the source unit and the number of IDs it uses or a null pointer if the
+	/// snapshot is invalid.
+	static std::pair<ASTPointer<SourceUnit>, size_t> deserialise(
+		bytesConstRef _snapshot,
+		std::shared_ptr<Scanner> const& _scanner
+	);
+};
+
+}
+}
@@ -101,8 +101,15 @@ void MemberList::combine(MemberList const & _other)
 	m_memberTypes += _other.m_memberTypes;
 }
 
+recursive_mutex& dev::solidity::lazyInitialisationMutex()
+{
+	static recursive_mutex mutex;
+	return mutex;
+}
+
 pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name) const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_storageOffsets)
 	{
 		TypePointers memberTypes;
@@ -275,6 +282,7 @@ TypePointer Type::commonType(TypePointer const& _a, TypePointer const& _b)
 
 MemberList const& Type::members(ContractDefinition const* _currentScope) const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_members[_currentScope])
 	{
 		MemberList::MemberMap members = nativeMembers(_currentScope);
@@ -1729,6 +1737,7 @@ void ContractType::addNonConflictingAddressMembers(MemberList::MemberMap& _membe
 
 shared_ptr<FunctionType const> const& ContractType::newExpressionType() const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_constructorType)
 		m_constructorType = FunctionType::newExpressionType(m_contract);
 	return m_constructorType;
@@ -1969,6 +1978,7 @@ set<string> StructType::membersMissingInMemory() const
 
 bool StructType::recursive() const
 {
+	lock_guard<recursive_mutex> lock(lazyInitialisationMutex());
 	if (!m_recursive.is_initialized())
 	{
 		set<StructDefinition const*> structsSeen;
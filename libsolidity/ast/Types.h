@@ -35,6 +35,7 @@
 #include <boost/optional.hpp>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <map>
 #include <set>
@@ -54,6 +55,11 @@ using rational = boost::rational<dev::bigint>;
 
 enum class DataLocation { Storage, CallData, Memory };
 
+/// @returns the mutex guarding the lazily computed caches of types and AST nodes (member lists,
+/// interface functions, ...). These objects are shared between contracts that are compiled
+/// in parallel.
+std::recursive_mutex& lazyInitialisationMutex();
+
 /**
  * Helper class to compute storage offsets of members of structs and contracts.
  */
@@ -36,9 +36,11 @@ namespace solidity {
 class Compiler
 {
 public:
-	explicit Compiler(EVMVersion _evmVersion = EVMVersion{}, bool _optimize = false, unsigned _runs = 200):
+	/// @param _optimizerThreads number of threads used to optimise sub-assemblies concurrently.
+	explicit Compiler(EVMVersion _evmVersion = EVMVersion{}, bool _optimize = false, unsigned _runs = 200, unsigned _optimizerThreads = 1):
 		m_optimize(_optimize),
 		m_optimizeRuns(_runs),
+		m_optimizerThreads(_optimizerThreads),
 		m_runtimeContext(_evmVersion),
 		m_context(_evmVersion, &m_runtimeContext)
 	{ }
@@ -84,6 +86,7 @@ public:
 private:
 	bool const m_optimize;
 	unsigned const m_optimizeRuns;
+	unsigned const m_optimizerThreads;
 	CompilerContext m_runtimeContext;
 	size_t m_runtimeSub = size_t(-1); ///< Identifier of the runtime sub-assembly, if present.
 	CompilerContext m_context;
@@ -591,7 +591,9 @@ bool ExpressionCompiler::visit(FunctionCall const& _functionCall)
 					eth::Assembly const& assembly = _context.compiledContract(*contract);
 					CompilerUtils(_context).fetchFreeMemoryPointer();
 					// pushes size
-					auto subroutine = _context.addSubroutine(make_shared<eth::Assembly>(assembly));
+					// The assembly of the other contract might be shared with contracts compiled
+					// in parallel, so take a copy that can be optimised independently.
+					auto subroutine = _context.addSubroutine(assembly.deepCopy());
 					_context << Instruction::DUP1 << subroutine;
 					_context << Instruction::DUP4 << Instruction::CODECOPY;
 					_context << Instruction::ADD;
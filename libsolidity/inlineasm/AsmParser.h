@@ -58,11 +58,11 @@ protected:
 			r.location.start = position();
 			r.location.end = endPosition();
 		}
-		if (!r.location.sourceName)
-			r.location.sourceName = sourceName();
+		if (r.location.sourceID < 0)
+			r.location.sourceID = sourceID();
 		return r;
 	}
-	SourceLocation location() const { return SourceLocation(position(), endPosition(), sourceName()); }
+	SourceLocation location() const { return SourceLocation(position(), endPosition(), sourceID()); }
 
 	Block parseBlock();
 	Statement parseStatement();
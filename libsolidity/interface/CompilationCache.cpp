@@ -0,0 +1,177 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Persistent, content-addressed cache for the compilation results of contracts.
+ */
+
+#include <libsolidity/interface/CompilationCache.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+CompilationCache::CompilationCache(string const& _directory, size_t _memoryLimit):
+	m_directory(_directory),
+	m_memoryLimit(_memoryLimit)
+{
+	if (m_directory.empty())
+		return;
+	try
+	{
+		boost::filesystem::create_directories(m_directory);
+	}
+	catch (...)
+	{
+		// Reported as cache misses later on.
+	}
+}
+
+Json::Value CompilationCache::load(h256 const& _key) const
+{
+	string const name = entryName(_key);
+	Json::Value entry;
+	try
+	{
+		string content;
+		if (shared_ptr<bytes const> data = loadFromMemory(name))
+			content = asString(*data);
+		else if (!m_directory.empty())
+		{
+			content = readFileAsString((m_directory / name).string());
+			if (!content.empty())
+				storeInMemory(name, make_shared<bytes const>(asBytes(content)));
+		}
+		if (content.empty() || !jsonParseStrict(content, entry) || !entry.isObject())
+			return Json::Value();
+	}
+	catch (...)
+	{
+		return Json::Value();
+	}
+	return entry;
+}
+
+void CompilationCache::store(h256 const& _key, Json::Value const& _entry) const
+{
+	try
+	{
+		string const name = entryName(_key);
+		string content = jsonCompactPrint(_entry);
+		if (!m_directory.empty())
+			// Write to a temporary file first so that concurrent readers never see partial entries.
+			writeFile((m_directory / name).string(), content, true);
+		storeInMemory(name, make_shared<bytes const>(asBytes(content)));
+	}
+	catch (...)
+	{
+	}
+}
+
+bool CompilationCache::readSnapshot(h256 const& _key, function<void(bytesConstRef)> const& _reader) const
+{
+	string const name = entryName(_key, ".ast");
+	if (shared_ptr<bytes const> data = loadFromMemory(name))
+	{
+		_reader(bytesConstRef(data.get()));
+		return true;
+	}
+	if (m_directory.empty())
+		return false;
+
+	using namespace boost::interprocess;
+	mapped_region region;
+	try
+	{
+		file_mapping file((m_directory / name).string().c_str(), read_only);
+		region = mapped_region(file, read_only);
+	}
+	catch (...)
+	{
+		return false;
+	}
+	bytesConstRef snapshot(static_cast<byte const*>(region.get_address()), region.get_size());
+	if (m_memoryLimit > 0)
+		storeInMemory(name, make_shared<bytes const>(snapshot.toBytes()));
+	_reader(snapshot);
+	return true;
+}
+
+void CompilationCache::storeSnapshot(h256 const& _key, bytes const& _snapshot) const
+{
+	string const name = entryName(_key, ".ast");
+	try
+	{
+		if (!m_directory.empty())
+			writeFile((m_directory / name).string(), _snapshot, true);
+		if (m_memoryLimit > 0)
+			storeInMemory(name, make_shared<bytes const>(_snapshot));
+	}
+	catch (...)
+	{
+	}
+}
+
+size_t CompilationCache::memoryUsage() const
+{
+	lock_guard<mutex> lock(m_memoryMutex);
+	return m_memoryUsage;
+}
+
+shared_ptr<bytes const> CompilationCache::loadFromMemory(string const& _name) const
+{
+	lock_guard<mutex> lock(m_memoryMutex);
+	auto it = m_memoryIndex.find(_name);
+	if (it == m_memoryIndex.end())
+		return nullptr;
+	m_memoryEntries.splice(m_memoryEntries.begin(), m_memoryEntries, it->second);
+	return it->second->second;
+}
+
+void CompilationCache::storeInMemory(string const& _name, shared_ptr<bytes const> _data) const
+{
+	if (_data->size() > m_memoryLimit)
+		return;
+	lock_guard<mutex> lock(m_memoryMutex);
+	auto it = m_memoryIndex.find(_name);
+	if (it != m_memoryIndex.end())
+	{
+		m_memoryUsage -= it->second->second->size();
+		m_memoryEntries.erase(it->second);
+	}
+	m_memoryUsage += _data->size();
+	m_memoryEntries.emplace_front(_name, std::move(_data));
+	m_memoryIndex[_name] = m_memoryEntries.begin();
+	while (m_memoryUsage > m_memoryLimit)
+	{
+		auto const& leastRecentlyUsed = m_memoryEntries.back();
+		m_memoryUsage -= leastRecentlyUsed.second->size();
+		m_memoryIndex.erase(leastRecentlyUsed.first);
+		m_memoryEntries.pop_back();
+	}
+}
+
+string CompilationCache::entryName(h256 const& _key, string const& _extension)
+{
+	return _key.hex() + _extension;
+}
@@ -0,0 +1,96 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Content-addressed cache for the compilation results of contracts.
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+
+#include <json/json.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Cache of compilation results, one file per entry inside a single directory.
+ * Besides JSON entries, it holds binary snapshots of parsed sources (see ASTSnapshot).
+ * Entries are keyed by a hash over everything the generated code of a contract depends on
+ * (see CompilerStack) and are never invalidated, only overwritten.
+ * Optionally, the most recently used entries are also kept in memory, which is intended
+ * for long-running processes like the compiler server.
+ * Failures to read or write the cache are not errors, they only result in cache misses.
+ * All functions can be called concurrently.
+ */
+class CompilationCache: boost::noncopyable
+{
+public:
+	/// Creates a cache that stores its entries in @a _directory, which is created if needed.
+	/// If @a _directory is empty, nothing is stored on disk. Up to @a _memoryLimit bytes of
+	/// entries are kept in memory, the least recently used ones are evicted first.
+	explicit CompilationCache(std::string const& _directory, size_t _memoryLimit = 0);
+
+	/// @returns the entry stored for @a _key or a null value if there is none.
+	Json::Value load(h256 const& _key) const;
+	/// Stores @a _entry for @a _key, replacing any previous entry.
+	void store(h256 const& _key, Json::Value const& _entry) const;
+
+	/// Maps the binary snapshot stored for @a _key into memory and calls @a _reader on it.
+	/// @returns false if there is no such snapshot.
+	bool readSnapshot(h256 const& _key, std::function<void(bytesConstRef)> const& _reader) const;
+	/// Stores the binary snapshot @a _snapshot for @a _key, replacing any previous one.
+	void storeSnapshot(h256 const& _key, bytes const& _snapshot) const;
+
+	/// @returns the number of bytes of entries kept in memory.
+	size_t memoryUsage() const;
+
+private:
+	/// @returns the entry called @a _name from memory, marking it as most recently used,
+	/// or a null pointer if it is not in memory.
+	std::shared_ptr<bytes const> loadFromMemory(std::string const& _name) const;
+	/// Keeps @a _data in memory as the entry called @a _name and evicts the least recently used
+	/// entries if the memory limit is exceeded.
+	void storeInMemory(std::string const& _name, std::shared_ptr<bytes const> _data) const;
+
+	static std::string entryName(h256 const& _key, std::string const& _extension = ".json");
+
+	boost::filesystem::path m_directory;
+	size_t m_memoryLimit = 0;
+
+	mutable std::mutex m_memoryMutex;
+	/// Entries in memory, most recently used first.
+	mutable std::list<std::pair<std::string, std::shared_ptr<bytes const>>> m_memoryEntries;
+	mutable std::map<std::string, decltype(m_memoryEntries)::iterator> m_memoryIndex;
+	mutable size_t m_memoryUsage = 0;
+};
+
+}
+}
@@ -0,0 +1,155 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Long-running compiler process handling a stream of standard JSON requests.
+ */
+
+#include <libsolidity/interface/CompilerServer.h>
+
+#include <libsolidity/interface/CompilationCache.h>
+#include <libsolidity/interface/StandardCompiler.h>
+
+#include <boost/algorithm/string/trim.hpp>
+
+#include <future>
+#include <iostream>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+CompilerServer::CompilerServer(
+	ReadCallback::Callback const& _readFile,
+	unsigned _threads,
+	shared_ptr<CompilationCache> _cache
+):
+	m_readFile(_readFile),
+	m_cache(std::move(_cache)),
+	m_maxPendingRequests(2 * max(_threads, 1u))
+{
+	for (unsigned i = 0; i < max(_threads, 1u); ++i)
+		m_workers.emplace_back([this]() { work(); });
+}
+
+CompilerServer::~CompilerServer()
+{
+	{
+		lock_guard<mutex> lock(m_tasksMutex);
+		m_stopping = true;
+	}
+	m_tasksCondition.notify_all();
+	for (thread& worker: m_workers)
+		worker.join();
+}
+
+void CompilerServer::serve(istream& _input, ostream& _output)
+{
+	serve(
+		[&](string& _request) { return bool(getline(_input, _request)); },
+		[&](string const& _response) { _output << _response << endl; }
+	);
+}
+
+void CompilerServer::serve(
+	function<bool(string&)> const& _readRequest,
+	function<void(string const&)> const& _writeResponse
+)
+{
+	mutex pendingMutex;
+	condition_variable pendingCondition;
+	// Responses in the order of the requests, removed once they are written.
+	deque<future<string>> pending;
+	bool inputEnded = false;
+
+	thread writer([&]()
+	{
+		while (true)
+		{
+			future<string> response;
+			{
+				unique_lock<mutex> lock(pendingMutex);
+				pendingCondition.wait(lock, [&]() { return !pending.empty() || inputEnded; });
+				if (pending.empty())
+					return;
+				response = std::move(pending.front());
+			}
+			_writeResponse(response.get());
+			{
+				lock_guard<mutex> lock(pendingMutex);
+				pending.pop_front();
+			}
+			pendingCondition.notify_all();
+		}
+	});
+
+	string request;
+	while (_readRequest(request))
+	{
+		boost::trim(request);
+		if (request.empty())
+			continue;
+		auto task = make_shared<packaged_task<string()>>([this, request]() { return compile(request); });
+		{
+			unique_lock<mutex> lock(pendingMutex);
+			pendingCondition.wait(lock, [&]() { return pending.size() < m_maxPendingRequests; });
+			pending.push_back(task->get_future());
+		}
+		pendingCondition.notify_all();
+		schedule([task]() { (*task)(); });
+	}
+
+	{
+		lock_guard<mutex> lock(pendingMutex);
+		inputEnded = true;
+	}
+	pendingCondition.notify_all();
+	writer.join();
+}
+
+string CompilerServer::compile(string const& _request) const
+{
+	StandardCompiler compiler(m_readFile);
+	compiler.setCompilationCache(m_cache);
+	return compiler.compile(_request);
+}
+
+void CompilerServer::schedule(function<void()> _task)
+{
+	{
+		lock_guard<mutex> lock(m_tasksMutex);
+		m_tasks.push_back(std::move(_task));
+	}
+	m_tasksCondition.notify_one();
+}
+
+void CompilerServer::work()
+{
+	while (true)
+	{
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(m_tasksMutex);
+			m_tasksCondition.wait(lock, [&]() { return !m_tasks.empty() || m_stopping; });
+			if (m_tasks.empty())
+				return;
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,97 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Long-running compiler process handling a stream of standard JSON requests.
+ */
+
+#pragma once
+
+#include <libsolidity/interface/ReadFile.h>
+
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+namespace solidity
+{
+
+class CompilationCache;
+
+/**
+ * Compiles standard JSON requests (see StandardCompiler) received as a stream of lines.
+ * Requests are compiled concurrently on a fixed number of worker threads and share a
+ * compilation cache, so that sources and contracts that were already part of previous
+ * requests are neither parsed nor compiled again.
+ */
+class CompilerServer: boost::noncopyable
+{
+public:
+	/// Creates a server with @a _threads worker threads.
+	/// @param _readFile callback used to read files for import statements, has to be
+	/// safe to call concurrently.
+	/// @param _cache cache shared by all requests or null.
+	CompilerServer(
+		ReadCallback::Callback const& _readFile,
+		unsigned _threads,
+		std::shared_ptr<CompilationCache> _cache
+	);
+	~CompilerServer();
+
+	/// Reads requests, one per line, from @a _input until its end and writes the responses to
+	/// @a _output, one per line and in the order of the requests. Empty lines are ignored.
+	/// Several streams can be served concurrently.
+	void serve(std::istream& _input, std::ostream& _output);
+	/// Same as above, but reads the requests using @a _readRequest until it returns false and
+	/// writes the responses using @a _writeResponse, which is called on a different thread.
+	void serve(
+		std::function<bool(std::string&)> const& _readRequest,
+		std::function<void(std::string const&)> const& _writeResponse
+	);
+
+	/// @returns the response to the single request @a _request, compiled on the calling thread.
+	std::string compile(std::string const& _request) const;
+
+private:
+	/// Schedules @a _task to run on one of the worker threads.
+	void schedule(std::function<void()> _task);
+	void work();
+
+	ReadCallback::Callback m_readFile;
+	std::shared_ptr<CompilationCache> m_cache;
+	/// Maximum number of requests per stream that are read ahead of the oldest unanswered one.
+	size_t m_maxPendingRequests;
+
+	std::mutex m_tasksMutex;
+	std::condition_variable m_tasksCondition;
+	std::deque<std::function<void()>> m_tasks;
+	bool m_stopping = false;
+	std::vector<std::thread> m_workers;
+};
+
+}
+}
@@ -27,6 +27,7 @@
 #include <libsolidity/interface/Version.h>
 #include <libsolidity/analysis/SemVerHandler.h>
 #include <libsolidity/ast/AST.h>
+#include <libsolidity/ast/ASTSnapshot.h>
 #include <libsolidity/parsing/Scanner.h>
 #include <libsolidity/parsing/Parser.h>
 #include <libsolidity/analysis/GlobalContext.h>
@@ -40,6 +41,7 @@
 #include <libsolidity/codegen/Compiler.h>
 #include <libsolidity/formal/SMTChecker.h>
 #include <libsolidity/interface/ABI.h>
+#include <libsolidity/interface/CompilationCache.h>
 #include <libsolidity/interface/Natspec.h>
 #include <libsolidity/interface/GasEstimator.h>
 
@@ -52,6 +54,11 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 using namespace std;
 using namespace dev;
 using namespace dev::solidity;
@@ -72,11 +79,16 @@ void CompilerStack::setRemappings(vector<string> const& _remappings)
 		remappings.push_back(r);
 	}
 	swap(m_remappings, remappings);
+	// Imports have to be resolved again.
+	m_analysedSources.clear();
 }
 
 void CompilerStack::setEVMVersion(EVMVersion _version)
 {
 	solAssert(m_stackState < State::ParsingSuccessful, "Set EVM version after parsing.");
+	if (!(_version == m_evmVersion))
+		// The type checker depends on the EVM version.
+		m_analysedSources.clear();
 	m_evmVersion = _version;
 }
 
@@ -85,7 +97,7 @@ void CompilerStack::reset(bool _keepSources)
 	if (_keepSources)
 	{
 		m_stackState = SourcesSet;
-		for (auto sourcePair: m_sources)
+		for (auto& sourcePair: m_sources)
 			sourcePair.second.reset();
 	}
 	else
@@ -97,18 +109,48 @@ void CompilerStack::reset(bool _keepSources)
 	m_evmVersion = EVMVersion();
 	m_optimize = false;
 	m_optimizeRuns = 200;
+	m_compilationThreads = 1;
+	m_generateBytecode = true;
+	m_generateCloneObjects = false;
 	m_globalContext.reset();
 	m_scopes.clear();
 	m_sourceOrder.clear();
 	m_contracts.clear();
 	m_errorReporter.clear();
+	m_errorOrigins.clear();
+	m_incrementalAnalysis = false;
+	m_astArena = true;
+	m_analysedSources.clear();
+	m_keptSources.clear();
+	// Together with the ASTs of the sources, this releases all arenas.
+	m_retiredASTs.clear();
 }
 
 bool CompilerStack::addSource(string const& _name, string const& _content, bool _isLibrary)
+{
+	return addSource(_name, CharStream(_content), _isLibrary);
+}
+
+bool CompilerStack::addSource(string const& _name, CharStream const& _source, bool _isLibrary)
 {
 	bool existed = m_sources.count(_name) != 0;
-	reset(true);
-	m_sources[_name].scanner = make_shared<Scanner>(CharStream(_content), _name);
+	if (m_incrementalAnalysis)
+	{
+		Source& source = m_sources[_name];
+		m_stackState = SourcesSet;
+		if (source.scanner && source.isLibrary == _isLibrary)
+		{
+			vector_ref<char const> oldText = source.scanner->source();
+			vector_ref<char const> newText = _source.source();
+			if (oldText.size() == newText.size() && equal(oldText.begin(), oldText.end(), newText.begin()))
+				return existed;
+		}
+		// Only this source and the sources importing it have to be analysed again.
+		m_analysedSources.erase(_name);
+	}
+	else
+		reset(true);
+	m_sources[_name].scanner = make_shared<Scanner>(_source, _name);
 	m_sources[_name].isLibrary = _isLibrary;
 	m_stackState = SourcesSet;
 	return existed;
@@ -119,33 +161,63 @@ bool CompilerStack::parse()
 	//reset
 	if(m_stackState != SourcesSet)
 		return false;
+	ASTNode::IDCounterScope idCounterScope(m_nodeIDCounter);
+
+	m_keptSources = reusableSources();
+	m_analysedSources = m_keptSources;
+	ErrorList keptErrors;
+	vector<string> keptErrorOrigins;
+	for (size_t i = 0; i < m_errorList.size() && i < m_errorOrigins.size(); ++i)
+		if (m_keptSources.count(m_errorOrigins[i]))
+		{
+			keptErrors.push_back(m_errorList[i]);
+			keptErrorOrigins.push_back(m_errorOrigins[i]);
+		}
 	m_errorReporter.clear();
-	ASTNode::resetID();
+	m_errorOrigins.clear();
+	if (m_keptSources.empty())
+	{
+		ASTNode::resetID();
+		m_retiredASTs.clear();
+		m_globalContext.reset();
+		m_scopes.clear();
+	}
 
 	if (SemVerVersion{string(VersionString)}.isPrerelease())
 		m_errorReporter.warning("This is a pre-release compiler version, please do not use it in production.");
+	attributeErrors(string());
+	m_errorList += keptErrors;
+	m_errorOrigins += keptErrorOrigins;
 
 	vector<string> sourcesToParse;
 	for (auto const& s: m_sources)
-		sourcesToParse.push_back(s.first);
-	for (size_t i = 0; i < sourcesToParse.size(); ++i)
+		if (!m_keptSources.count(s.first))
+			sourcesToParse.push_back(s.first);
+	for (size_t i = 0; i < sourcesToParse.size();)
 	{
-		string const& path = sourcesToParse[i];
-		Source& source = m_sources[path];
-		source.scanner->reset();
-		source.ast = Parser(m_errorReporter).parse(source.scanner);
-		if (!source.ast)
-			solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
-		else
+		// All sources known so far are parsed (in parallel, if enabled)
+		// and the imports found in them form the next batch.
+		size_t batchEnd = sourcesToParse.size();
+		map<string, ErrorList> parserErrors =
+			parseSources(vector<string>(sourcesToParse.begin() + i, sourcesToParse.end()));
+		for (; i < batchEnd; ++i)
 		{
-			source.ast->annotation().path = path;
-			for (auto const& newSource: loadMissingSources(*source.ast, path))
+			string const path = sourcesToParse[i];
+			Source& source = m_sources[path];
+			m_errorList += parserErrors[path];
+			if (!source.ast)
+				solAssert(!Error::containsOnlyWarnings(m_errorReporter.errors()), "Parser returned null but did not report error.");
+			else
 			{
-				string const& newPath = newSource.first;
-				string const& newContents = newSource.second;
-				m_sources[newPath].scanner = make_shared<Scanner>(CharStream(newContents), newPath);
-				sourcesToParse.push_back(newPath);
+				source.ast->annotation().path = path;
+				for (auto& newSource: loadMissingSources(*source.ast, path))
+				{
+					string const& newPath = newSource.first;
+					m_sources[newPath].scanner = make_shared<Scanner>(CharStream(move(newSource.second)), newPath);
+					sourcesToParse.push_back(newPath);
+				}
 			}
+			attributeErrors(path);
 		}
 	}
 	if (Error::containsOnlyWarnings(m_errorReporter.errors()))
@@ -157,37 +229,169 @@ bool CompilerStack::parse()
 		return false;
 }
 
+map<string, ErrorList> CompilerStack::parseSources(vector<string> const& _sourceNames)
+{
+	struct ParsedSource
+	{
+		shared_ptr<SourceUnit> ast;
+		ErrorList errors;
+		size_t ids = 0;
+		exception_ptr failure;
+	};
+	vector<ParsedSource> parsedSources(_sourceNames.size());
+	atomic<size_t> nextSource{0};
+	auto worker = [&]()
+	{
+		for (size_t i = nextSource++; i < _sourceNames.size(); i = nextSource++)
+		{
+			ParsedSource& parsedSource = parsedSources[i];
+			shared_ptr<Scanner> const& scanner = m_sources.at(_sourceNames[i]).scanner;
+			Timings::Scope timingsScope(m_timings.get(), _sourceNames[i]);
+			try
+			{
+				// Each source has its own arena, so the arena of a source that is parsed again
+				// in incremental mode is released together with its previous AST.
+				shared_ptr<ASTArena> arena = m_astArena ? make_shared<ASTArena>() : nullptr;
+				ASTNode::ArenaScope arenaScope(arena);
+				h256 snapshotKey;
+				if (m_compilationCache)
+				{
+					Timings::Timer timer("Loading AST snapshot");
+					// The parser only depends on the source code and the compiler version.
+					snapshotKey = dev::keccak256(
+						string(VersionString) + '\0' + dev::keccak256(bytesConstRef(scanner->source())).hex()
+					);
+					m_compilationCache->readSnapshot(snapshotKey, [&](bytesConstRef _snapshot)
+					{
+						tie(parsedSource.ast, parsedSource.ids) = ASTSnapshot::deserialise(_snapshot, scanner);
+					});
+				}
+				if (parsedSource.ast)
+					continue;
+				ErrorReporter errorReporter(parsedSource.errors);
+				parsedSource.ids = ASTNode::withLocalIDs([&]()
+				{
+					// The scanner runs on demand of the parser.
+					Timings::Timer timer("Scanning and parsing");
+					scanner->reset();
+					parsedSource.ast = Parser(errorReporter).parse(scanner);
+				});
+				if (m_compilationCache && parsedSource.ast && parsedSource.errors.empty())
+					m_compilationCache->storeSnapshot(
+						snapshotKey,
+						ASTSnapshot::serialise(*parsedSource.ast, 0, parsedSource.ids)
+					);
+			}
+			catch (...)
+			{
+				parsedSource.failure = current_exception();
+			}
+		}
+	};
+	if (m_compilationThreads > 1)
+	{
+		vector<thread> workers;
+		for (unsigned i = 0; i < min<size_t>(m_compilationThreads, _sourceNames.size()); ++i)
+			workers.emplace_back(worker);
+		for (thread& w: workers)
+			w.join();
+	}
+	else
+		worker();
+
+	// Assign the IDs that parsing the sources one after the other would have assigned.
+	map<string, ErrorList> errors;
+	for (size_t i = 0; i < _sourceNames.size(); ++i)
+	{
+		ParsedSource& parsedSource = parsedSources[i];
+		if (parsedSource.failure)
+			rethrow_exception(parsedSource.failure);
+		Source& source = m_sources.at(_sourceNames[i]);
+		if (source.ast && !m_keptSources.empty())
+			m_retiredASTs.push_back(source.ast);
+		size_t offset = ASTNode::reserveIDs(parsedSource.ids);
+		if (parsedSource.ast)
+			ASTNode::shiftIDs(*parsedSource.ast, offset);
+		source.ast = std::move(parsedSource.ast);
+		errors[_sourceNames[i]] = std::move(parsedSource.errors);
+	}
+	return errors;
+}
+
 bool CompilerStack::analyze()
 {
 	if (m_stackState != ParsingSuccessful)
 		return false;
+	ASTNode::IDCounterScope idCounterScope(m_nodeIDCounter);
 	resolveImports();
 
+	// Reused sources keep their annotations and are not analysed again.
+	vector<Source const*> sourcesToAnalyse;
+	for (Source const* source: m_sourceOrder)
+		if (!m_keptSources.count(source->ast->annotation().path))
+			sourcesToAnalyse.push_back(source);
+
 	bool noErrors = true;
 	SyntaxChecker syntaxChecker(m_errorReporter);
-	for (Source const* source: m_sourceOrder)
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("SyntaxChecker");
 		if (!syntaxChecker.checkSyntax(*source->ast))
 			noErrors = false;
+		attributeErrors(source->ast->annotation().path);
+	}
 
 	DocStringAnalyser docStringAnalyser(m_errorReporter);
-	for (Source const* source: m_sourceOrder)
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("DocStringAnalyser");
 		if (!docStringAnalyser.analyseDocStrings(*source->ast))
 			noErrors = false;
+		attributeErrors(source->ast->annotation().path);
+	}
 
-	m_globalContext = make_shared<GlobalContext>();
-	NameAndTypeResolver resolver(m_globalContext->declarations(), m_scopes, m_errorReporter);
-	for (Source const* source: m_sourceOrder)
+	vector<Declaration const*> globalDeclarations;
+	if (!m_globalContext)
+	{
+		m_globalContext = make_shared<GlobalContext>();
+		globalDeclarations = m_globalContext->declarations();
+	}
+	// The global declarations of a reused context are already registered in the global scope.
+	NameAndTypeResolver resolver(globalDeclarations, m_scopes, m_errorReporter);
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("NameAndTypeResolver");
 		if (!resolver.registerDeclarations(*source->ast))
 			return false;
+		attributeErrors(source->ast->annotation().path);
+	}
 
 	map<string, SourceUnit const*> sourceUnitsByName;
 	for (auto& source: m_sources)
 		sourceUnitsByName[source.first] = source.second.ast.get();
-	for (Source const* source: m_sourceOrder)
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("NameAndTypeResolver");
 		if (!resolver.performImports(*source->ast, sourceUnitsByName))
 			return false;
+		attributeErrors(source->ast->annotation().path);
+	}
 
+	m_contracts.clear();
 	for (Source const* source: m_sourceOrder)
+		if (m_keptSources.count(source->ast->annotation().path))
+			for (ContractDefinition const* contract: source->ast->filteredNodes<ContractDefinition>(source->ast->nodes()))
+				if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
+					m_contracts[contract->fullyQualifiedName()].contract = contract;
+
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("NameAndTypeResolver");
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
 			{
@@ -204,28 +408,45 @@ bool CompilerStack::analyze()
 				if (m_contracts.find(contract->fullyQualifiedName()) == m_contracts.end())
 					m_contracts[contract->fullyQualifiedName()].contract = contract;
 			}
+		attributeErrors(source->ast->annotation().path);
+	}
 
 	TypeChecker typeChecker(m_evmVersion, m_errorReporter);
-	for (Source const* source: m_sourceOrder)
+	for (Source const* source: sourcesToAnalyse)
+	{
+		Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+		Timings::Timer timer("TypeChecker");
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
 				if (!typeChecker.checkTypeRequirements(*contract))
 					noErrors = false;
+		attributeErrors(source->ast->annotation().path);
+	}
 
 	if (noErrors)
 	{
 		PostTypeChecker postTypeChecker(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
+		for (Source const* source: sourcesToAnalyse)
+		{
+			Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+			Timings::Timer timer("PostTypeChecker");
 			if (!postTypeChecker.check(*source->ast))
 				noErrors = false;
+			attributeErrors(source->ast->annotation().path);
+		}
 	}
 
 	if (noErrors)
 	{
 		StaticAnalyzer staticAnalyzer(m_errorReporter);
-		for (Source const* source: m_sourceOrder)
+		for (Source const* source: sourcesToAnalyse)
+		{
+			Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+			Timings::Timer timer("StaticAnalyzer");
 			if (!staticAnalyzer.analyze(*source->ast))
 				noErrors = false;
+			attributeErrors(source->ast->annotation().path);
+		}
 	}
 
 	if (noErrors)
@@ -234,19 +455,45 @@ bool CompilerStack::analyze()
 		for (Source const* source: m_sourceOrder)
 			ast.push_back(source->ast);
 
-		if (!ViewPureChecker(ast, m_errorReporter).check())
-			noErrors = false;
+		// The check needs all sources because of modifiers, but the errors
+		// of reused sources have been reported before.
+		ErrorList viewPureErrors;
+		ErrorReporter viewPureErrorReporter(viewPureErrors);
+		{
+			// Attributed to all sources.
+			Timings::Scope timingsScope(m_timings.get(), string());
+			Timings::Timer timer("ViewPureChecker");
+			if (!ViewPureChecker(ast, viewPureErrorReporter).check())
+				noErrors = false;
+		}
+		for (auto const& error: viewPureErrors)
+		{
+			SourceLocation const* location = boost::get_error_info<errinfo_sourceLocation>(*error);
+			string origin = location && location->sourceName() ? *location->sourceName() : string();
+			if (!m_keptSources.count(origin))
+			{
+				m_errorList.push_back(error);
+				attributeErrors(origin);
+			}
+		}
 	}
 
 	if (noErrors)
 	{
 		SMTChecker smtChecker(m_errorReporter, m_smtQuery);
-		for (Source const* source: m_sourceOrder)
+		for (Source const* source: sourcesToAnalyse)
+		{
+			Timings::Scope timingsScope(m_timings.get(), source->ast->annotation().path);
+			Timings::Timer timer("SMTChecker");
 			smtChecker.analyze(*source->ast);
+			attributeErrors(source->ast->annotation().path);
+		}
 	}
 
 	if (noErrors)
 	{
+		for (Source const* source: m_sourceOrder)
+			m_analysedSources.insert(source->ast->annotation().path);
 		m_stackState = AnalysisSuccessful;
 		return true;
 	}
@@ -259,6 +506,44 @@ bool CompilerStack::parseAndAnalyze()
 	return parse() && analyze();
 }
 
+set<string> CompilerStack::reusableSources() const
+{
+	if (!m_incrementalAnalysis)
+		return set<string>();
+
+	// Sources importing a source that has to be analysed again have to be analysed again, too.
+	set<string> reusable = m_analysedSources;
+	for (bool changed = true; changed;)
+	{
+		changed = false;
+		for (auto it = reusable.begin(); it != reusable.end();)
+		{
+			bool importsChangedSource = false;
+			for (ASTPointer<ASTNode> const& node: m_sources.at(*it).ast->nodes())
+				if (ImportDirective const* import = dynamic_cast<ImportDirective const*>(node.get()))
+					if (!reusable.count(import->annotation().absolutePath))
+						importsChangedSource = true;
+			if (importsChangedSource)
+			{
+				it = reusable.erase(it);
+				changed = true;
+			}
+			else
+				++it;
+		}
+	}
+
+	// Start from scratch once more ASTs are retired than alive.
+	if (m_retiredASTs.size() > m_sources.size())
+		return set<string>();
+	return reusable;
+}
+
+void CompilerStack::attributeErrors(string const& _sourceName)
+{
+	m_errorOrigins.resize(m_errorList.size(), _sourceName);
+}
+
 bool CompilerStack::isRequestedContract(ContractDefinition const& _contract) const
 {
 	return
@@ -269,18 +554,56 @@ bool CompilerStack::isRequestedContract(ContractDefinition const& _contract) con
 
 bool CompilerStack::compile()
 {
+	ASTNode::IDCounterScope idCounterScope(m_nodeIDCounter);
 	if (m_stackState < AnalysisSuccessful)
 		if (!parseAndAnalyze())
 			return false;
+	if (!m_generateBytecode)
+		return true;
 
-	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
-	for (Source const* source: m_sourceOrder)
-		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
-			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
-				if (isRequestedContract(*contract))
-					compileContract(*contract, compiledContracts);
+	// Contracts found in the compilation cache only need to be compiled if other contracts create them.
+	map<ContractDefinition const*, Json::Value> cachedContracts;
+	if (m_compilationCache)
+		cachedContracts = loadCachedContracts();
+	auto needsCompilation = [&](ContractDefinition const& _contract)
+	{
+		return isRequestedContract(_contract) && !cachedContracts.count(&_contract);
+	};
+
+	if (m_compilationThreads > 1)
+	{
+		// Collect the contracts in the order in which they would be compiled serially.
+		vector<ContractDefinition const*> contracts;
+		set<ContractDefinition const*> contractsSeen;
+		function<void(ContractDefinition const&)> addContract = [&](ContractDefinition const& _contract)
+		{
+			if (contractsSeen.count(&_contract) || !isCompilable(_contract))
+				return;
+			contractsSeen.insert(&_contract);
+			for (auto const* dependency: compilableDependencies(_contract))
+				addContract(*dependency);
+			contracts.push_back(&_contract);
+		};
+		for (Source const* source: m_sourceOrder)
+			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+				if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+					if (needsCompilation(*contract))
+						addContract(*contract);
+		compileContractsInParallel(contracts);
+	}
+	else
+	{
+		map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+		for (Source const* source: m_sourceOrder)
+			for (ASTPointer<ASTNode> const& node: source->ast->nodes())
+				if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+					if (needsCompilation(*contract))
+						compileContract(*contract, compiledContracts);
+	}
 	this->link();
 	m_stackState = CompilationSuccessful;
+	if (m_compilationCache)
+		updateCompilationCache(cachedContracts);
 	return true;
 }
 
@@ -290,7 +613,6 @@ void CompilerStack::link()
 	{
 		contract.second.object.link(m_libraries);
 		contract.second.runtimeObject.link(m_libraries);
-		contract.second.cloneObject.link(m_libraries);
 	}
 }
 
@@ -371,7 +693,21 @@ eth::LinkerObject const& CompilerStack::runtimeObject(string const& _contractNam
 
 eth::LinkerObject const& CompilerStack::cloneObject(string const& _contractName) const
 {
-	return contract(_contractName).cloneObject;
+	Contract const& c = contract(_contractName);
+	lock_guard<mutex> lock(m_cloneObjectMutex);
+	if (!c.cloneObject)
+	{
+		static eth::LinkerObject const emptyObject;
+		if (m_stackState != CompilationSuccessful || !c.compiler)
+			return emptyObject;
+		// Every contract compiled together with this one is available for contract creation.
+		map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+		for (auto const& contract: m_contracts)
+			if (contract.second.compiler)
+				compiledContracts[contract.second.contract] = &contract.second.compiler->assembly();
+		c.cloneObject.reset(new eth::LinkerObject(compileClone(*c.contract, compiledContracts)));
+	}
+	return *c.cloneObject;
 }
 
 /// FIXME: cache this string
@@ -478,10 +814,21 @@ Json::Value CompilerStack::methodIdentifiers(string const& _contractName) const
 
 string const& CompilerStack::metadata(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	return metadata(contract(_contractName));
+}
+
+string const& CompilerStack::metadata(Contract const& _contract) const
+{
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
+
+	solAssert(_contract.contract, "");
+
+	// caches the result
+	if (!_contract.metadata)
+		_contract.metadata.reset(new string(createMetadata(_contract)));
 
-	return contract(_contractName).metadata;
+	return *_contract.metadata;
 }
 
 Scanner const& CompilerStack::scanner(string const& _sourceName) const
@@ -502,8 +849,8 @@ SourceUnit const& CompilerStack::ast(string const& _sourceName) const
 
 ContractDefinition const& CompilerStack::contractDefinition(string const& _contractName) const
 {
-	if (m_stackState != CompilationSuccessful)
-		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Compilation was not successful."));
+	if (m_stackState < AnalysisSuccessful)
+		BOOST_THROW_EXCEPTION(CompilerError() << errinfo_comment("Parsing was not successful."));
 
 	return *contract(_contractName).contract;
 }
@@ -532,8 +879,8 @@ tuple<int, int, int, int> CompilerStack::positionFromSourceLocation(SourceLocati
 	int startColumn;
 	int endLine;
 	int endColumn;
-	tie(startLine, startColumn) = scanner(*_sourceLocation.sourceName).translatePositionToLineColumn(_sourceLocation.start);
-	tie(endLine, endColumn) = scanner(*_sourceLocation.sourceName).translatePositionToLineColumn(_sourceLocation.end);
+	tie(startLine, startColumn) = scanner(*_sourceLocation.sourceName()).translatePositionToLineColumn(_sourceLocation.start);
+	tie(endLine, endColumn) = scanner(*_sourceLocation.sourceName()).translatePositionToLineColumn(_sourceLocation.end);
 
 	return make_tuple(++startLine, ++startColumn, ++endLine, ++endColumn);
 }
@@ -670,23 +1017,252 @@ bool onlySafeExperimentalFeaturesActivated(set<ExperimentalFeature> const& featu
 }
 }
 
+bool CompilerStack::isCompilable(ContractDefinition const& _contract) const
+{
+	return _contract.annotation().unimplementedFunctions.empty() && _contract.constructorIsPublic();
+}
+
+set<ContractDefinition const*> CompilerStack::compilableDependencies(ContractDefinition const& _contract) const
+{
+	set<ContractDefinition const*> dependencies;
+	set<ContractDefinition const*> visited;
+	function<void(ContractDefinition const&)> collect = [&](ContractDefinition const& _dependent)
+	{
+		for (auto const* dependency: _dependent.annotation().contractDependencies)
+			if (visited.insert(dependency).second)
+			{
+				if (isCompilable(*dependency))
+					dependencies.insert(dependency);
+				else
+					collect(*dependency);
+			}
+	};
+	collect(_contract);
+	return dependencies;
+}
+
 void CompilerStack::compileContract(
 	ContractDefinition const& _contract,
 	map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
 )
 {
-	if (
-		_compiledContracts.count(&_contract) ||
-		!_contract.annotation().unimplementedFunctions.empty() ||
-		!_contract.constructorIsPublic()
-	)
+	if (_compiledContracts.count(&_contract) || !isCompilable(_contract))
 		return;
-	for (auto const* dependency: _contract.annotation().contractDependencies)
+	for (auto const* dependency: compilableDependencies(_contract))
 		compileContract(*dependency, _compiledContracts);
+	generateCode(_contract, _compiledContracts);
+}
+
+void CompilerStack::compileContractsInParallel(vector<ContractDefinition const*> const& _contracts)
+{
+	map<ContractDefinition const*, size_t> indices;
+	for (size_t i = 0; i < _contracts.size(); ++i)
+		indices[_contracts[i]] = i;
+
+	// Number of dependencies still to be compiled and reverse dependency edges.
+	vector<size_t> pendingDependencies(_contracts.size(), 0);
+	vector<vector<size_t>> dependents(_contracts.size());
+	// Contracts ready to be compiled, ordered by their position in the serial order.
+	set<size_t> ready;
+	for (size_t i = 0; i < _contracts.size(); ++i)
+	{
+		for (auto const* dependency: compilableDependencies(*_contracts[i]))
+			if (indices.count(dependency))
+			{
+				pendingDependencies[i]++;
+				dependents[indices.at(dependency)].push_back(i);
+			}
+		if (pendingDependencies[i] == 0)
+			ready.insert(i);
+	}
+
+	mutex scheduleMutex;
+	condition_variable scheduleCondition;
+	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	map<size_t, exception_ptr> failures;
+	size_t running = 0;
+
+	auto worker = [&]()
+	{
+		unique_lock<mutex> lock(scheduleMutex);
+		while (true)
+		{
+			scheduleCondition.wait(lock, [&]() { return !ready.empty() || running == 0; });
+			if (ready.empty())
+				return;
+			size_t index = *ready.begin();
+			ready.erase(ready.begin());
+			ContractDefinition const& contract = *_contracts[index];
+			map<ContractDefinition const*, eth::Assembly const*> availableContracts = compiledContracts;
+			running++;
+			lock.unlock();
+
+			exception_ptr failure;
+			try
+			{
+				generateCode(contract, availableContracts);
+			}
+			catch (...)
+			{
+				failure = current_exception();
+			}
+
+			lock.lock();
+			running--;
+			if (failure)
+				// Contracts depending on this one are never scheduled.
+				failures[index] = failure;
+			else
+			{
+				compiledContracts[&contract] = availableContracts.at(&contract);
+				for (size_t dependent: dependents[index])
+					if (--pendingDependencies[dependent] == 0)
+						ready.insert(dependent);
+			}
+			scheduleCondition.notify_all();
+		}
+	};
+
+	vector<thread> workers;
+	for (unsigned i = 0; i < m_compilationThreads; ++i)
+		workers.emplace_back(worker);
+	for (thread& w: workers)
+		w.join();
+
+	// All contracts preceding the first failure in serial order have been compiled successfully,
+	// so this is the same failure the serial compilation reports.
+	if (!failures.empty())
+		rethrow_exception(failures.begin()->second);
+}
+
+namespace
+{
+
+Json::Value linkerObjectToJson(eth::LinkerObject const& _object)
+{
+	Json::Value output(Json::objectValue);
+	output["bytecode"] = toHex(_object.bytecode);
+	output["linkReferences"] = Json::objectValue;
+	for (auto const& reference: _object.linkReferences)
+		output["linkReferences"][to_string(reference.first)] = reference.second;
+	return output;
+}
+
+eth::LinkerObject linkerObjectFromJson(Json::Value const& _input)
+{
+	eth::LinkerObject object;
+	object.bytecode = fromHex(_input["bytecode"].asString(), WhenError::Throw);
+	for (auto const& offset: _input["linkReferences"].getMemberNames())
+		object.linkReferences[stoul(offset)] = _input["linkReferences"][offset].asString();
+	return object;
+}
+
+bool isValidLinkerObject(Json::Value const& _input)
+{
+	if (!_input.isObject() || !_input["bytecode"].isString() || !_input["linkReferences"].isObject())
+		return false;
+	try
+	{
+		linkerObjectFromJson(_input);
+	}
+	catch (...)
+	{
+		return false;
+	}
+	return true;
+}
+
+bool isValidCacheEntry(Json::Value const& _entry, bool _requireCloneObject, bool _requireGasEstimates)
+{
+	for (char const* object: {"object", "runtimeObject"})
+		if (!isValidLinkerObject(_entry[object]))
+			return false;
+	if (_requireCloneObject && !isValidLinkerObject(_entry["cloneObject"]))
+		return false;
+	for (char const* field: {"metadata", "sourceMap", "runtimeSourceMap"})
+		if (!_entry[field].isString())
+			return false;
+	return !_requireGasEstimates || _entry["gasEstimates"].isObject();
+}
+
+}
+
+h256 CompilerStack::compilationCacheKey(Contract const& _contract) const
+{
+	Json::Value keyData(Json::objectValue);
+	keyData["metadata"] = metadata(_contract);
+	keyData["cloneObjects"] = m_generateCloneObjects;
+	keyData["sourceNames"] = Json::arrayValue;
+	for (string const& sourceName: sourceNames())
+		keyData["sourceNames"].append(sourceName);
+	return dev::keccak256(jsonCompactPrint(keyData));
+}
+
+map<ContractDefinition const*, Json::Value> CompilerStack::loadCachedContracts() const
+{
+	solAssert(m_compilationCache, "");
+	map<ContractDefinition const*, Json::Value> cachedContracts;
+	for (auto const& contract: m_contracts)
+	{
+		ContractDefinition const& definition = *contract.second.contract;
+		if (!isRequestedContract(definition) || !isCompilable(definition))
+			continue;
+		Json::Value entry = m_compilationCache->load(compilationCacheKey(contract.second));
+		if (isValidCacheEntry(entry, m_generateCloneObjects, m_cacheGasEstimates))
+			cachedContracts[&definition] = std::move(entry);
+	}
+	return cachedContracts;
+}
+
+void CompilerStack::updateCompilationCache(map<ContractDefinition const*, Json::Value> const& _cachedContracts)
+{
+	solAssert(m_compilationCache, "");
+	for (auto& contract: m_contracts)
+	{
+		Contract& compiledContract = contract.second;
+		auto cached = _cachedContracts.find(compiledContract.contract);
+		if (compiledContract.compiler && cached == _cachedContracts.end())
+		{
+			Json::Value entry(Json::objectValue);
+			entry["object"] = linkerObjectToJson(compiledContract.object);
+			entry["runtimeObject"] = linkerObjectToJson(compiledContract.runtimeObject);
+			if (m_generateCloneObjects)
+				entry["cloneObject"] = linkerObjectToJson(cloneObject(contract.first));
+			entry["metadata"] = metadata(compiledContract);
+			entry["sourceMap"] = *sourceMapping(contract.first);
+			entry["runtimeSourceMap"] = *runtimeSourceMapping(contract.first);
+			if (m_cacheGasEstimates)
+			{
+				compiledContract.gasEstimates.reset(new Json::Value(gasEstimates(contract.first)));
+				entry["gasEstimates"] = *compiledContract.gasEstimates;
+			}
+			m_compilationCache->store(compilationCacheKey(compiledContract), entry);
+		}
+		else if (!compiledContract.compiler && cached != _cachedContracts.end())
+		{
+			Json::Value const& entry = cached->second;
+			compiledContract.object = linkerObjectFromJson(entry["object"]);
+			compiledContract.runtimeObject = linkerObjectFromJson(entry["runtimeObject"]);
+			if (entry.isMember("cloneObject"))
+				compiledContract.cloneObject.reset(new eth::LinkerObject(linkerObjectFromJson(entry["cloneObject"])));
+			compiledContract.metadata.reset(new string(entry["metadata"].asString()));
+			compiledContract.sourceMapping.reset(new string(entry["sourceMap"].asString()));
+			compiledContract.runtimeSourceMapping.reset(new string(entry["runtimeSourceMap"].asString()));
+			if (entry.isMember("gasEstimates"))
+				compiledContract.gasEstimates.reset(new Json::Value(entry["gasEstimates"]));
+		}
+	}
+}
 
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimize, m_optimizeRuns);
+void CompilerStack::generateCode(
+	ContractDefinition const& _contract,
+	map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
+)
+{
+	Timings::Scope timingsScope(m_timings.get(), _contract.fullyQualifiedName());
+	shared_ptr<Compiler> compiler = make_shared<Compiler>(m_evmVersion, m_optimize, m_optimizeRuns, m_compilationThreads);
 	Contract& compiledContract = m_contracts.at(_contract.fullyQualifiedName());
-	string metadata = createMetadata(compiledContract);
+	string const& metadata = this->metadata(compiledContract);
 	bytes cborEncodedHash =
 		// CBOR-encoding of the key "bzzr0"
 		bytes{0x65, 'b', 'z', 'z', 'r', '0'}+
@@ -707,9 +1283,15 @@ void CompilerStack::compileContract(
 	solAssert(cborEncodedMetadata.size() <= 0xffff, "Metadata too large");
 	// 16-bit big endian length
 	cborEncodedMetadata += toCompactBigEndian(cborEncodedMetadata.size(), 2);
-	compiler->compileContract(_contract, _compiledContracts, cborEncodedMetadata);
+	{
+		// Includes the optimiser.
+		Timings::Timer timer("Code generation");
+		compiler->compileContract(_contract, _compiledContracts, cborEncodedMetadata);
+	}
 	compiledContract.compiler = compiler;
 
+	Timings::Timer timer("Assembling");
+
 	try
 	{
 		compiledContract.object = compiler->assembledObject();
@@ -736,17 +1318,27 @@ void CompilerStack::compileContract(
 		solAssert(false, "Assembly exception for deployed bytecode");
 	}
 
-	compiledContract.metadata = metadata;
 	_compiledContracts[compiledContract.contract] = &compiler->assembly();
 
+	// Otherwise the clone is compiled on the first call to cloneObject.
+	if (m_generateCloneObjects)
+		compiledContract.cloneObject.reset(new eth::LinkerObject(compileClone(_contract, _compiledContracts)));
+}
+
+eth::LinkerObject CompilerStack::compileClone(
+	ContractDefinition const& _contract,
+	map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+) const
+{
+	if (_contract.isLibrary())
+		return eth::LinkerObject();
 	try
 	{
-		if (!_contract.isLibrary())
-		{
-			Compiler cloneCompiler(m_evmVersion, m_optimize, m_optimizeRuns);
-			cloneCompiler.compileClone(_contract, _compiledContracts);
-			compiledContract.cloneObject = cloneCompiler.assembledObject();
-		}
+		Compiler cloneCompiler(m_evmVersion, m_optimize, m_optimizeRuns, m_compilationThreads);
+		cloneCompiler.compileClone(_contract, _compiledContracts);
+		eth::LinkerObject cloneObject = cloneCompiler.assembledObject();
+		cloneObject.link(m_libraries);
+		return cloneObject;
 	}
 	catch (eth::AssemblyException const&)
 	{
@@ -754,6 +1346,7 @@ void CompilerStack::compileContract(
 		// possible to compile the clone.
 
 		// TODO: Report error / warning
+		return eth::LinkerObject();
 	}
 }
 
@@ -831,16 +1424,17 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 			continue;
 
 		solAssert(s.second.scanner, "Scanner not available");
-		meta["sources"][s.first]["keccak256"] =
-			"0x" + toHex(dev::keccak256(s.second.scanner->source()).asBytes());
+		bytesConstRef source(s.second.scanner->source());
+		meta["sources"][s.first]["keccak256"] = "0x" + toHex(dev::keccak256(source).asBytes());
 		if (m_metadataLiteralSources)
-			meta["sources"][s.first]["content"] = s.second.scanner->source();
+			meta["sources"][s.first]["content"] = Json::Value(
+				reinterpret_cast<char const*>(source.begin()),
+				reinterpret_cast<char const*>(source.end())
+			);
 		else
 		{
 			meta["sources"][s.first]["urls"] = Json::arrayValue;
-			meta["sources"][s.first]["urls"].append(
-				"bzzr://" + toHex(dev::swarmHash(s.second.scanner->source()).asBytes())
-			);
+			meta["sources"][s.first]["urls"].append("bzzr://" + toHex(dev::swarmHash(source).asBytes()));
 		}
 	}
 	meta["settings"]["optimizer"]["enabled"] = m_optimize;
@@ -870,7 +1464,15 @@ string CompilerStack::createMetadata(Contract const& _contract) const
 string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) const
 {
 	string ret;
-	map<string, unsigned> sourceIndicesMap = sourceIndices();
+	// Source indices by source ID, -1 for sources that are not part of this compilation.
+	vector<int> sourceIndicesByID;
+	for (auto const& source: sourceIndices())
+	{
+		size_t id = size_t(SourceNames::id(source.first));
+		if (id >= sourceIndicesByID.size())
+			sourceIndicesByID.resize(id + 1, -1);
+		sourceIndicesByID[id] = int(source.second);
+	}
 	int prevStart = -1;
 	int prevLength = -1;
 	int prevSourceIndex = -1;
@@ -883,8 +1485,8 @@ string CompilerStack::computeSourceMapping(eth::AssemblyItems const& _items) con
 		SourceLocation const& location = item.location();
 		int length = location.start != -1 && location.end != -1 ? location.end - location.start : -1;
 		int sourceIndex =
-			location.sourceName && sourceIndicesMap.count(*location.sourceName) ?
-			sourceIndicesMap.at(*location.sourceName) :
+			location.sourceID >= 0 && size_t(location.sourceID) < sourceIndicesByID.size() ?
+			sourceIndicesByID[size_t(location.sourceID)] :
 			-1;
 		char jump = '-';
 		if (item.getJumpType() == eth::AssemblyItem::JumpType::IntoFunction)
@@ -955,6 +1557,8 @@ Json::Value gasToJson(GasEstimator::GasConsumption const& _gas)
 
 Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 {
+	if (Json::Value const* cachedEstimates = contract(_contractName).gasEstimates.get())
+		return *cachedEstimates;
 	if (!assemblyItems(_contractName) && !runtimeAssemblyItems(_contractName))
 		return Json::Value();
 
@@ -962,43 +1566,37 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 	GasEstimator gasEstimator(m_evmVersion);
 	Json::Value output(Json::objectValue);
 
-	if (eth::AssemblyItems const* items = assemblyItems(_contractName))
-	{
-		Gas executionGas = gasEstimator.functionalEstimation(*items);
-		u256 bytecodeSize(runtimeObject(_contractName).bytecode.size());
-		Gas codeDepositGas = bytecodeSize * eth::GasCosts::createDataGas;
-
-		Json::Value creation(Json::objectValue);
-		creation["codeDepositCost"] = gasToJson(codeDepositGas);
-		creation["executionCost"] = gasToJson(executionGas);
-		/// TODO: implement + overload to avoid the need of +=
-		executionGas += codeDepositGas;
-		creation["totalCost"] = gasToJson(executionGas);
-		output["creation"] = creation;
-	}
-
-	if (eth::AssemblyItems const* items = runtimeAssemblyItems(_contractName))
+	// The estimations are independent of each other, so they are collected first and then run
+	// on m_compilationThreads threads.
+	vector<function<Gas()>> estimations;
+	eth::AssemblyItems const* creationItems = assemblyItems(_contractName);
+	if (creationItems)
+		estimations.push_back([&]() { return gasEstimator.functionalEstimation(*creationItems); });
+
+	eth::AssemblyItems const* items = runtimeAssemblyItems(_contractName);
+	vector<string> externalSignatures;
+	vector<string> internalSignatures;
+	if (items)
 	{
 		/// External functions
 		ContractDefinition const& contract = contractDefinition(_contractName);
-		Json::Value externalFunctions(Json::objectValue);
 		for (auto it: contract.interfaceFunctions())
 		{
 			string sig = it.second->externalSignature();
-			externalFunctions[sig] = gasToJson(gasEstimator.functionalEstimation(*items, sig));
+			externalSignatures.push_back(sig);
+			estimations.push_back([&, sig]() { return gasEstimator.functionalEstimation(*items, sig); });
 		}
 
 		if (contract.fallbackFunction())
+		{
+			externalSignatures.push_back("");
 			/// This needs to be set to an invalid signature in order to trigger the fallback,
 			/// without the shortcut (of CALLDATSIZE == 0), and therefore to receive the upper bound.
 			/// An empty string ("") would work to trigger the shortcut only.
-			externalFunctions[""] = gasToJson(gasEstimator.functionalEstimation(*items, "INVALID"));
-
-		if (!externalFunctions.empty())
-			output["external"] = externalFunctions;
+			estimations.push_back([&]() { return gasEstimator.functionalEstimation(*items, "INVALID"); });
+		}
 
 		/// Internal functions
-		Json::Value internalFunctions(Json::objectValue);
 		for (auto const& it: contract.definedFunctions())
 		{
 			/// Exclude externally visible functions, constructor and the fallback function
@@ -1006,9 +1604,14 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 				continue;
 
 			size_t entry = functionEntryPoint(_contractName, *it);
-			GasEstimator::GasConsumption gas = GasEstimator::GasConsumption::infinite();
-			if (entry > 0)
-				gas = gasEstimator.functionalEstimation(*items, entry, *it);
+			FunctionDefinition const& function = *it;
+			estimations.push_back([&, entry]()
+			{
+				if (entry > 0)
+					return gasEstimator.functionalEstimation(*items, entry, function);
+				else
+					return GasEstimator::GasConsumption::infinite();
+			});
 
 			/// TODO: This could move into a method shared with externalSignature()
 			FunctionType type(*it);
@@ -1017,10 +1620,39 @@ Json::Value CompilerStack::gasEstimates(string const& _contractName) const
 			for (auto it = paramTypes.begin(); it != paramTypes.end(); ++it)
 				sig += (*it)->toString() + (it + 1 == paramTypes.end() ? "" : ",");
 			sig += ")";
-
-			internalFunctions[sig] = gasToJson(gas);
+			internalSignatures.push_back(sig);
 		}
+	}
+
+	vector<Gas> gas = GasEstimator::runEstimations(estimations, m_compilationThreads);
+	auto nextGas = gas.begin();
+
+	if (creationItems)
+	{
+		Gas executionGas = *nextGas++;
+		u256 bytecodeSize(runtimeObject(_contractName).bytecode.size());
+		Gas codeDepositGas = bytecodeSize * eth::GasCosts::createDataGas;
 
+		Json::Value creation(Json::objectValue);
+		creation["codeDepositCost"] = gasToJson(codeDepositGas);
+		creation["executionCost"] = gasToJson(executionGas);
+		/// TODO: implement + overload to avoid the need of +=
+		executionGas += codeDepositGas;
+		creation["totalCost"] = gasToJson(executionGas);
+		output["creation"] = creation;
+	}
+
+	if (items)
+	{
+		Json::Value externalFunctions(Json::objectValue);
+		for (string const& sig: externalSignatures)
+			externalFunctions[sig] = gasToJson(*nextGas++);
+		if (!externalFunctions.empty())
+			output["external"] = externalFunctions;
+
+		Json::Value internalFunctions(Json::objectValue);
+		for (string const& sig: internalSignatures)
+			internalFunctions[sig] = gasToJson(*nextGas++);
 		if (!internalFunctions.empty())
 			output["internal"] = internalFunctions;
 	}
@@ -32,6 +32,7 @@
 
 #include <libdevcore/Common.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/Timings.h>
 
 #include <json/json.h>
 
@@ -41,7 +42,9 @@
 #include <ostream>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
+#include <set>
 #include <functional>
 
 namespace dev
@@ -59,6 +62,7 @@ namespace solidity
 
 // forward declarations
 class Scanner;
+class CharStream;
 class ASTNode;
 class ContractDefinition;
 class FunctionDefinition;
@@ -68,6 +72,7 @@ class GlobalContext;
 class Natspec;
 class Error;
 class DeclarationContainer;
+class CompilationCache;
 
 /**
  * Easy to use and self-contained Solidity compiler with as few header dependencies as possible.
@@ -124,6 +129,26 @@ public:
 
 	void setEVMVersion(EVMVersion _version = EVMVersion{});
 
+	/// Sets the number of threads used for parsing and code generation. Sources are parsed as soon
+	/// as they are discovered and contracts are scheduled along their dependency graph, i.e. a contract
+	/// is compiled as soon as all contracts it creates are available. The sub-assemblies of a contract,
+	/// e.g. of the contracts it creates, are also optimised concurrently.
+	/// The default of 1 parses and compiles serially. The output does not depend on this setting.
+	/// Will not take effect before running compile.
+	void setCompilationThreads(unsigned _threads = 1) { m_compilationThreads = _threads > 0 ? _threads : 1; }
+
+	/// Sets a cache that is used to skip code generation for contracts compiled before with
+	/// identical sources and settings. Contracts loaded from the cache do not have assembly items,
+	/// so their assembly output is empty and their gas estimates are only available if
+	/// @a _cacheGasEstimates is true. The cache also stores snapshots of the parsed sources, which
+	/// replace parsing sources that did not change. A null cache disables caching. Not cleared by reset.
+	/// Will not take effect before running parse or compile.
+	void setCompilationCache(std::shared_ptr<CompilationCache> _cache, bool _cacheGasEstimates = false)
+	{
+		m_compilationCache = std::move(_cache);
+		m_cacheGasEstimates = _cacheGasEstimates;
+	}
+
 	/// Sets the list of requested contract names. If empty, no filtering is performed and every contract
 	/// found in the supplied sources is compiled. Names are cleared iff @a _contractNames is missing.
 	void setRequestedContractNames(std::set<std::string> const& _contractNames = std::set<std::string>{})
@@ -131,12 +156,47 @@ public:
 		m_requestedContractNames = _contractNames;
 	}
 
+	/// Selects the outputs of the code generator. If @a _bytecode is false, compile() stops after
+	/// analysis and only the outputs derived from the AST (ABI, documentation, metadata and method
+	/// identifiers) are available. If @a _cloneObjects is true, the clone objects are generated
+	/// together with the bytecode and stored in the compilation cache, otherwise they are only
+	/// generated on the first call to cloneObject.
+	/// Source mappings and gas estimates are always computed on request only.
+	/// Will not take effect before running compile.
+	void setRequestedOutputs(bool _bytecode, bool _cloneObjects = false)
+	{
+		m_generateBytecode = _bytecode;
+		m_generateCloneObjects = _cloneObjects;
+	}
+
 	/// @arg _metadataLiteralSources When true, store sources as literals in the contract metadata.
 	void useMetadataLiteralSources(bool _metadataLiteralSources) { m_metadataLiteralSources = _metadataLiteralSources; }
 
+	/// Enables incremental analysis, intended for repeated analysis of slowly changing sources.
+	/// If enabled, addSource does not reset the compiler and parse and analyze only process the sources
+	/// that changed since the last successful analysis and the sources that (transitively) import them.
+	/// All other sources keep their ASTs, annotations and errors. Node IDs of re-parsed sources
+	/// continue the previous numbering, so they differ from those of a full compilation.
+	void useIncrementalAnalysis(bool _incrementalAnalysis) { m_incrementalAnalysis = _incrementalAnalysis; }
+
+	/// Enables allocating the nodes and annotations of each parsed source from an arena, which is
+	/// released as a whole once the AST of the source is discarded, at the latest by reset.
+	/// Enabled by default. Will not take effect before running parse.
+	void useASTArena(bool _astArena) { m_astArena = _astArena; }
+
+	/// Enables or disables measuring the time spent in each phase of the compilation per source
+	/// and contract, discarding previous measurements. Not cleared by reset.
+	void useTimings(bool _timings) { m_timings.reset(_timings ? new Timings() : nullptr); }
+	/// @returns the measurements taken since timings were enabled or a null pointer if they are disabled.
+	Timings const* timings() const { return m_timings.get(); }
+
 	/// Adds a source object (e.g. file) to the parser. After this, parse has to be called again.
 	/// @returns true if a source object by the name already existed and was replaced.
 	bool addSource(std::string const& _name, std::string const& _content, bool _isLibrary = false);
+	/// Adds a source object whose text is shared with @a _source instead of copied. If the stream
+	/// does not own its text, the text has to outlive the compiler stack.
+	/// @returns true if a source object by the name already existed and was replaced.
+	bool addSource(std::string const& _name, CharStream const& _source, bool _isLibrary = false);
 
 	/// Parses all source units that were added
 	/// @returns false on error.
@@ -192,6 +252,9 @@ public:
 	/// The returned bytes will contain a sequence of 20 bytes of the format "XXX...XXX" which have to
 	/// substituted by the actual address. Note that this sequence starts end ends in three X
 	/// characters but can contain anything in between.
+	/// The clone object is generated on the first call unless it was requested via setRequestedOutputs.
+	/// It is empty for contracts loaded from the compilation cache if it was not requested.
+	/// Concurrent calls are safe.
 	eth::LinkerObject const& cloneObject(std::string const& _contractName) const;
 
 	/// @returns normal contract assembly items
@@ -234,6 +297,7 @@ public:
 	Json::Value methodIdentifiers(std::string const& _contractName) const;
 
 	/// @returns the Contract Metadata
+	/// Prerequisite: Successful call to parse or compile.
 	std::string const& metadata(std::string const& _contractName) const;
 
 	/// @returns a JSON representing the estimated gas usage for contract creation, internal and external functions
@@ -248,7 +312,9 @@ private:
 		std::shared_ptr<Scanner> scanner;
 		std::shared_ptr<SourceUnit> ast;
 		bool isLibrary = false;
-		void reset() { scanner.reset(); ast.reset(); }
+		/// Releases the AST together with its arena. The scanner holds the source text, which is
+		/// needed to parse the source again.
+		void reset() { ast.reset(); }
 	};
 
 	struct Contract
@@ -257,13 +323,15 @@ private:
 		std::shared_ptr<Compiler> compiler;
 		eth::LinkerObject object;
 		eth::LinkerObject runtimeObject;
-		eth::LinkerObject cloneObject;
-		std::string metadata; ///< The metadata json that will be hashed into the chain.
+		mutable std::unique_ptr<eth::LinkerObject const> cloneObject;
+		mutable std::unique_ptr<std::string const> metadata; ///< The metadata json that will be hashed into the chain.
 		mutable std::unique_ptr<Json::Value const> abi;
 		mutable std::unique_ptr<Json::Value const> userDocumentation;
 		mutable std::unique_ptr<Json::Value const> devDocumentation;
 		mutable std::unique_ptr<std::string const> sourceMapping;
 		mutable std::unique_ptr<std::string const> runtimeSourceMapping;
+		/// Only set for contracts that are stored in or loaded from the compilation cache.
+		mutable std::unique_ptr<Json::Value const> gasEstimates;
 	};
 
 	/// Loads the missing sources from @a _ast (named @a _path) using the callback
@@ -280,11 +348,57 @@ private:
 	/// @returns true if the contract is requested to be compiled.
 	bool isRequestedContract(ContractDefinition const& _contract) const;
 
-	/// Compile a single contract and put the result in @a _compiledContracts.
+	/// @returns false if no code can be generated for the contract, i.e. if it is abstract
+	/// or does not have a public constructor.
+	bool isCompilable(ContractDefinition const& _contract) const;
+	/// @returns the compilable contracts whose code can end up in the code of @a _contract.
+	/// Dependencies of contracts that are not compilable themselves (e.g. abstract bases)
+	/// are followed, since their creation code is still needed.
+	std::set<ContractDefinition const*> compilableDependencies(ContractDefinition const& _contract) const;
+
+	/// Parses the given sources on m_compilationThreads worker threads or restores their ASTs
+	/// from the snapshots in the compilation cache, if there is one.
+	/// The resulting node IDs are the same as if they were parsed one after the other.
+	/// @returns the errors reported for each of the sources.
+	std::map<std::string, ErrorList> parseSources(std::vector<std::string> const& _sourceNames);
+	/// @returns the names of the sources whose ASTs and analysis results from the previous
+	/// analysis can be reused, i.e. those that were analysed successfully and only (transitively)
+	/// import such sources. Empty if incremental analysis is disabled.
+	std::set<std::string> reusableSources() const;
+	/// Records @a _sourceName as the origin of all errors reported since the last call,
+	/// used to retain the errors of reused sources.
+	void attributeErrors(std::string const& _sourceName);
+
+	/// Compile a single contract and its dependencies and put the result in @a _compiledContracts.
 	void compileContract(
 		ContractDefinition const& _contract,
 		std::map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
 	);
+	/// Generates the code of a single contract and puts the result in @a _compiledContracts.
+	/// All contracts @a _contract depends on have to be present in @a _compiledContracts already.
+	void generateCode(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
+	);
+	/// Compiles the given contracts (sorted such that dependencies come first) on
+	/// m_compilationThreads worker threads.
+	void compileContractsInParallel(std::vector<ContractDefinition const*> const& _contracts);
+	/// @returns the linked object of the clone of @a _contract or an empty object if the clone
+	/// cannot be compiled. All contracts @a _contract creates have to be present in @a _compiledContracts.
+	eth::LinkerObject compileClone(
+		ContractDefinition const& _contract,
+		std::map<ContractDefinition const*, eth::Assembly const*> const& _compiledContracts
+	) const;
+	/// @returns the key of the compilation cache entry for the contract. It covers everything the
+	/// generated code depends on: the metadata (sources, settings and compiler version), the
+	/// source indices used in the source mappings and whether the entry contains the clone object.
+	h256 compilationCacheKey(Contract const& _contract) const;
+	/// @returns the compilation cache entries of the requested contracts that are found in the cache.
+	std::map<ContractDefinition const*, Json::Value> loadCachedContracts() const;
+	/// Fills the requested contracts that were not compiled from @a _cachedContracts and
+	/// stores the compiled ones that were not found in the cache. Has to be called after linking,
+	/// the stored objects are linked against the libraries that are part of the key.
+	void updateCompilationCache(std::map<ContractDefinition const*, Json::Value> const& _cachedContracts);
 	void link();
 
 	Contract const& contract(std::string const& _contractName) const;
@@ -296,6 +410,7 @@ private:
 
 	std::string createMetadata(Contract const& _contract) const;
 	std::string computeSourceMapping(eth::AssemblyItems const& _items) const;
+	std::string const& metadata(Contract const&) const;
 	Json::Value const& contractABI(Contract const&) const;
 	Json::Value const& natspecUser(Contract const&) const;
 	Json::Value const& natspecDev(Contract const&) const;
@@ -319,7 +434,16 @@ private:
 	bool m_optimize = false;
 	unsigned m_optimizeRuns = 200;
 	EVMVersion m_evmVersion;
+	unsigned m_compilationThreads = 1;
+	std::shared_ptr<CompilationCache> m_compilationCache;
+	std::unique_ptr<Timings> m_timings;
+	bool m_cacheGasEstimates = false;
 	std::set<std::string> m_requestedContractNames;
+	bool m_generateBytecode = true;
+	bool m_generateCloneObjects = false;
+	/// Guards the clone objects generated on demand by cloneObject, which can be called
+	/// concurrently since it is const.
+	mutable std::mutex m_cloneObjectMutex;
 	std::map<std::string, h160> m_libraries;
 	/// list of path prefix remappings, e.g. mylibrary: github.com/ethereum = /usr/local/ethereum
 	/// "context:prefix=target"
@@ -332,6 +456,21 @@ private:
 	ErrorList m_errorList;
 	ErrorReporter m_errorReporter;
 	bool m_metadataLiteralSources = false;
+	bool m_incrementalAnalysis = false;
+	bool m_astArena = true;
+	/// Sources whose analysis completed successfully and that did not change since.
+	std::set<std::string> m_analysedSources;
+	/// Sources reused by the current incremental analysis.
+	std::set<std::string> m_keptSources;
+	/// ASTs replaced during incremental analysis. Scopes, the global context and cached member lists
+	/// of reused types are keyed by AST node addresses, so the ASTs are kept alive until the next
+	/// full analysis to prevent their addresses from being reused.
+	std::vector<std::shared_ptr<SourceUnit>> m_retiredASTs;
+	/// Name of the source whose parsing or analysis reported the error at the same index in m_errorList.
+	std::vector<std::string> m_errorOrigins;
+	/// Counter for the IDs of the nodes created by this compiler, which keeps
+	/// the IDs independent of other compilations running concurrently.
+	size_t m_nodeIDCounter = 0;
 	State m_stackState = Empty;
 };
 
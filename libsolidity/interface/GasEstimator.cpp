@@ -22,8 +22,10 @@
 
 #include "GasEstimator.h"
 #include <map>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <thread>
 #include <libdevcore/SHA3.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/KnownState.h>
@@ -170,6 +172,43 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 	return PathGasMeter(_items, m_evmVersion).estimateMax(_offset, state);
 }
 
+vector<GasEstimator::GasConsumption> GasEstimator::runEstimations(
+	vector<function<GasConsumption()>> const& _estimations,
+	unsigned _threads
+)
+{
+	vector<GasConsumption> results(_estimations.size());
+	vector<exception_ptr> failures(_estimations.size());
+	atomic<size_t> nextEstimation{0};
+	auto worker = [&]()
+	{
+		for (size_t i = nextEstimation++; i < _estimations.size(); i = nextEstimation++)
+			try
+			{
+				results[i] = _estimations[i]();
+			}
+			catch (...)
+			{
+				failures[i] = current_exception();
+			}
+	};
+	if (_threads > 1 && _estimations.size() > 1)
+	{
+		vector<thread> workers;
+		for (unsigned i = 0; i < min<size_t>(_threads, _estimations.size()); ++i)
+			workers.emplace_back(worker);
+		for (thread& w: workers)
+			w.join();
+	}
+	else
+		worker();
+
+	for (exception_ptr const& failure: failures)
+		if (failure)
+			rethrow_exception(failure);
+	return results;
+}
+
 set<ASTNode const*> GasEstimator::finestNodesAtLocation(
 	vector<ASTNode const*> const& _roots
 )
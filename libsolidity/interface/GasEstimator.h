@@ -27,6 +27,7 @@
 #include <libevmasm/GasMeter.h>
 #include <libevmasm/Assembly.h>
 
+#include <functional>
 #include <vector>
 #include <map>
 #include <array>
@@ -81,6 +82,14 @@ public:
 		FunctionDefinition const& _function
 	) const;
 
+	/// Runs the given independent estimations, e.g. calls to functionalEstimation, on up to
+	/// @a _threads threads.
+	/// @returns their results in the same order.
+	static std::vector<GasConsumption> runEstimations(
+		std::vector<std::function<GasConsumption()>> const& _estimations,
+		unsigned _threads
+	);
+
 private:
 	/// @returns the set of AST nodes which are the finest nodes at their location.
 	static std::set<ASTNode const*> finestNodesAtLocation(std::vector<ASTNode const*> const& _roots);
@@ -23,6 +23,7 @@
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/SourceReferenceFormatter.h>
 #include <libsolidity/ast/ASTJsonConverter.h>
+#include <libsolidity/parsing/Scanner.h>
 #include <libevmasm/Instruction.h>
 #include <libdevcore/JSON.h>
 #include <libdevcore/SHA3.h>
@@ -84,9 +85,9 @@ Json::Value formatErrorWithException(
 		message = _message;
 
 	Json::Value sourceLocation;
-	if (location && location->sourceName)
+	if (location && location->sourceName())
 	{
-		sourceLocation["file"] = *location->sourceName;
+		sourceLocation["file"] = *location->sourceName();
 		sourceLocation["start"] = location->start;
 		sourceLocation["end"] = location->end;
 	}
@@ -94,20 +95,25 @@ Json::Value formatErrorWithException(
 	return formatError(_warning, _type, _component, message, formattedMessage, sourceLocation);
 }
 
-set<string> requestedContractNames(Json::Value const& _outputSelection)
+/// @returns the artifacts that can only be produced by generating code.
+vector<string> const& codeArtifacts()
 {
-	set<string> names;
-	for (auto const& sourceName: _outputSelection.getMemberNames())
-	{
-		for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
-		{
-			/// Consider the "all sources" shortcuts as requesting everything.
-			if (contractName == "*" || contractName == "")
-				return set<string>();
-			names.insert((sourceName == "*" ? "" : sourceName) + ":" + contractName);
-		}
-	}
-	return names;
+	static vector<string> const artifacts{
+		"evm.assembly",
+		"evm.legacyAssembly",
+		"evm.gasEstimates",
+		"evm.bytecode",
+		"evm.bytecode.object",
+		"evm.bytecode.opcodes",
+		"evm.bytecode.sourceMap",
+		"evm.bytecode.linkReferences",
+		"evm.deployedBytecode",
+		"evm.deployedBytecode.object",
+		"evm.deployedBytecode.opcodes",
+		"evm.deployedBytecode.sourceMap",
+		"evm.deployedBytecode.linkReferences"
+	};
+	return artifacts;
 }
 
 /// Returns true iff @a _hash (hex with 0x prefix) is the Keccak256 hash of the binary data in @a _content.
@@ -142,6 +148,14 @@ bool isArtifactRequested(Json::Value const& _outputSelection, string const& _art
 	return false;
 }
 
+bool isArtifactRequested(Json::Value const& _outputSelection, vector<string> const& _artifacts)
+{
+	for (auto const& artifact: _artifacts)
+		if (isArtifactRequested(_outputSelection, artifact))
+			return true;
+	return false;
+}
+
 ///
 /// @a _outputSelection is a JSON object containining a two-level hashmap, where the first level is the filename,
 /// the second level is the contract name and the value is an array of artifact names to be requested for that contract.
@@ -188,6 +202,40 @@ bool isArtifactRequested(Json::Value const& _outputSelection, string const& _fil
 	return false;
 }
 
+/// @returns true if any of @a _artifacts is requested for any contract in @a _outputSelection.
+bool isArtifactRequestedForAnyContract(Json::Value const& _outputSelection, vector<string> const& _artifacts)
+{
+	if (!_outputSelection.isObject())
+		return false;
+	for (auto const& sourceName: _outputSelection.getMemberNames())
+		if (_outputSelection[sourceName].isObject())
+			for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
+				if (!contractName.empty() && isArtifactRequested(_outputSelection, sourceName, contractName, _artifacts))
+					return true;
+	return false;
+}
+
+/// @returns the names of the contracts for which any of @a _artifacts is requested.
+set<string> requestedContractNames(Json::Value const& _outputSelection, vector<string> const& _artifacts)
+{
+	set<string> names;
+	for (auto const& sourceName: _outputSelection.getMemberNames())
+	{
+		for (auto const& contractName: _outputSelection[sourceName].getMemberNames())
+		{
+			/// Source unit level selections do not concern contracts.
+			Json::Value const& artifacts = _outputSelection[sourceName][contractName];
+			if (contractName.empty() || !artifacts.isArray() || !isArtifactRequested(artifacts, _artifacts))
+				continue;
+			/// Consider the "all sources" shortcuts as requesting everything.
+			if (contractName == "*")
+				return set<string>();
+			names.insert((sourceName == "*" ? "" : sourceName) + ":" + contractName);
+		}
+	}
+	return names;
+}
+
 Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkReferences)
 {
 	Json::Value ret(Json::objectValue);
@@ -215,12 +263,15 @@ Json::Value formatLinkReferences(std::map<size_t, std::string> const& linkRefere
 	return ret;
 }
 
-Json::Value collectEVMObject(eth::LinkerObject const& _object, string const* _sourceMap)
+/// @param _sourceMap the source map or null if it is not available.
+/// @param _withSourceMap whether the source map was requested, it is left out otherwise.
+Json::Value collectEVMObject(eth::LinkerObject const& _object, string const* _sourceMap, bool _withSourceMap)
 {
 	Json::Value output = Json::objectValue;
 	output["object"] = _object.toHex();
 	output["opcodes"] = solidity::disassemble(_object.bytecode);
-	output["sourceMap"] = _sourceMap ? *_sourceMap : "";
+	if (_withSourceMap)
+		output["sourceMap"] = _sourceMap ? *_sourceMap : "";
 	output["linkReferences"] = formatLinkReferences(_object.linkReferences);
 	return output;
 }
@@ -268,7 +319,7 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 					"Mismatch between content and supplied hash for \"" + sourceName + "\""
 				));
 			else
-				m_compilerStack.addSource(sourceName, content);
+				m_compilerStack.addSource(sourceName, CharStream(move(content)));
 		}
 		else if (sources[sourceName]["urls"].isArray())
 		{
@@ -292,7 +343,7 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 						));
 					else
 					{
-						m_compilerStack.addSource(sourceName, result.responseOrErrorMessage);
+						m_compilerStack.addSource(sourceName, CharStream(move(result.responseOrErrorMessage)));
 						found = true;
 						break;
 					}
@@ -380,8 +431,23 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	Json::Value metadataSettings = settings.get("metadata", Json::Value());
 	m_compilerStack.useMetadataLiteralSources(metadataSettings.get("useLiteralContent", Json::Value(false)).asBool());
 
+	m_compilerStack.useTimings(settings.get("timings", Json::Value(false)).asBool());
+
 	Json::Value outputSelection = settings.get("outputSelection", Json::Value());
-	m_compilerStack.setRequestedContractNames(requestedContractNames(outputSelection));
+	// Code is only generated for the contracts whose bytecode, assembly or gas estimates are requested.
+	// Standard JSON has no output for the objects that clone contracts.
+	bool const codeRequested = isArtifactRequestedForAnyContract(outputSelection, codeArtifacts());
+	m_compilerStack.setRequestedContractNames(requestedContractNames(outputSelection, codeArtifacts()));
+	m_compilerStack.setRequestedOutputs(codeRequested, false);
+
+	// Assembly items are not stored in the cache, so it cannot be used for outputs based on them.
+	if (m_compilationCache && !isArtifactRequestedForAnyContract(outputSelection, {"evm.assembly", "evm.legacyAssembly"}))
+		m_compilerStack.setCompilationCache(
+			m_compilationCache,
+			isArtifactRequestedForAnyContract(outputSelection, {"evm.gasEstimates"})
+		);
+	else
+		m_compilerStack.setCompilationCache(nullptr);
 
 	auto scannerFromSourceName = [&](string const& _sourceName) -> solidity::Scanner const& { return m_compilerStack.scanner(_sourceName); };
 
@@ -478,7 +544,9 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	}
 
 	bool const analysisSuccess = m_compilerStack.state() >= CompilerStack::State::AnalysisSuccessful;
-	bool const compilationSuccess = m_compilerStack.state() == CompilerStack::State::CompilationSuccessful;
+	bool const compilationSuccess = codeRequested ?
+		m_compilerStack.state() == CompilerStack::State::CompilationSuccessful :
+		analysisSuccess;
 
 	/// Inconsistent state - stop here to receive error reports from users
 	if (!compilationSuccess && (errors.size() == 0))
@@ -489,6 +557,9 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 	if (errors.size() > 0)
 		output["errors"] = errors;
 
+	if (Timings const* timings = m_compilerStack.timings())
+		output["timings"] = timings->toJson();
+
 	output["sources"] = Json::objectValue;
 	unsigned sourceIndex = 0;
 	for (string const& sourceName: analysisSuccess ? m_compilerStack.sourceNames() : vector<string>())
@@ -539,10 +610,14 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 			name,
 			{ "evm.bytecode", "evm.bytecode.object", "evm.bytecode.opcodes", "evm.bytecode.sourceMap", "evm.bytecode.linkReferences" }
 		))
+		{
+			bool withSourceMap = isArtifactRequested(outputSelection, file, name, vector<string>{ "evm.bytecode", "evm.bytecode.sourceMap" });
 			evmData["bytecode"] = collectEVMObject(
 				m_compilerStack.object(contractName),
-				m_compilerStack.sourceMapping(contractName)
+				withSourceMap ? m_compilerStack.sourceMapping(contractName) : nullptr,
+				withSourceMap
 			);
+		}
 
 		if (isArtifactRequested(
 			outputSelection,
@@ -550,10 +625,14 @@ Json::Value StandardCompiler::compileInternal(Json::Value const& _input)
 			name,
 			{ "evm.deployedBytecode", "evm.deployedBytecode.object", "evm.deployedBytecode.opcodes", "evm.deployedBytecode.sourceMap", "evm.deployedBytecode.linkReferences" }
 		))
+		{
+			bool withSourceMap = isArtifactRequested(outputSelection, file, name, vector<string>{ "evm.deployedBytecode", "evm.deployedBytecode.sourceMap" });
 			evmData["deployedBytecode"] = collectEVMObject(
 				m_compilerStack.runtimeObject(contractName),
-				m_compilerStack.runtimeSourceMapping(contractName)
+				withSourceMap ? m_compilerStack.runtimeSourceMapping(contractName) : nullptr,
+				withSourceMap
 			);
+		}
 
 		contractData["evm"] = evmData;
 
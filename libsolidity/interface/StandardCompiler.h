@@ -52,11 +52,16 @@ public:
 	/// output. Parsing errors are returned as regular errors.
 	std::string compile(std::string const& _input);
 
+	/// Sets a cache for the compilation results of contracts, see CompilerStack::setCompilationCache.
+	/// It is not used if assembly output is requested.
+	void setCompilationCache(std::shared_ptr<CompilationCache> _cache) { m_compilationCache = std::move(_cache); }
+
 private:
 	Json::Value compileInternal(Json::Value const& _input);
 
 	CompilerStack m_compilerStack;
 	ReadCallback::Callback m_readFile;
+	std::shared_ptr<CompilationCache> m_compilationCache;
 };
 
 }
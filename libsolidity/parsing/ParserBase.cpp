@@ -28,9 +28,9 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
-std::shared_ptr<string const> const& ParserBase::sourceName() const
+int ParserBase::sourceID() const
 {
-	return m_scanner->sourceName();
+	return m_scanner->sourceID();
 }
 
 int ParserBase::position() const
@@ -116,10 +116,10 @@ void ParserBase::decreaseRecursionDepth()
 
 void ParserBase::parserError(string const& _description)
 {
-	m_errorReporter.parserError(SourceLocation(position(), position(), sourceName()), _description);
+	m_errorReporter.parserError(SourceLocation(position(), position(), sourceID()), _description);
 }
 
 void ParserBase::fatalParserError(string const& _description)
 {
-	m_errorReporter.fatalParserError(SourceLocation(position(), position(), sourceName()), _description);
+	m_errorReporter.fatalParserError(SourceLocation(position(), position(), sourceID()), _description);
 }
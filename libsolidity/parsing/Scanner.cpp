@@ -55,6 +55,10 @@
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/parsing/Scanner.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace dev
@@ -100,6 +104,90 @@ int hexValue(char c)
 		return c - 'A' + 10;
 	else return -1;
 }
+
+#ifdef __SSE2__
+/// @returns a mask of the characters of @a _block that are in the range [_min, _max].
+/// Non-ASCII characters are negative and thus never in the range.
+__m128i inRange(__m128i _block, char _min, char _max)
+{
+	return _mm_and_si128(
+		_mm_cmpgt_epi8(_block, _mm_set1_epi8(_min - 1)),
+		_mm_cmplt_epi8(_block, _mm_set1_epi8(_max + 1))
+	);
+}
+#endif
+
+/// Set of up to four characters.
+class CharSet
+{
+public:
+	CharSet(initializer_list<char> _chars)
+	{
+		solAssert(1 <= _chars.size() && _chars.size() <= 4, "");
+		for (size_t i = 0; i < 4; ++i)
+			m_chars[i] = *(_chars.begin() + min(i, _chars.size() - 1));
+	}
+	bool contains(char _c) const
+	{
+		return _c == m_chars[0] || _c == m_chars[1] || _c == m_chars[2] || _c == m_chars[3];
+	}
+#ifdef __SSE2__
+	/// @returns a bit mask of the characters of @a _block that are in the set.
+	int contains(__m128i _block) const
+	{
+		__m128i matches = _mm_cmpeq_epi8(_block, _mm_set1_epi8(m_chars[0]));
+		for (size_t i = 1; i < 4; ++i)
+			matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_block, _mm_set1_epi8(m_chars[i])));
+		return _mm_movemask_epi8(matches);
+	}
+#endif
+
+private:
+	char m_chars[4];
+};
+
+/// Set of the characters that can be part of an identifier.
+struct IdentifierPartSet
+{
+	bool contains(char _c) const { return isIdentifierPart(_c); }
+#ifdef __SSE2__
+	/// @returns a bit mask of the characters of @a _block that are in the set.
+	int contains(__m128i _block) const
+	{
+		// Setting bit 0x20 maps upper case letters to lower case letters and no other
+		// character to a letter.
+		__m128i matches = inRange(_mm_or_si128(_block, _mm_set1_epi8(0x20)), 'a', 'z');
+		matches = _mm_or_si128(matches, inRange(_block, '0', '9'));
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_block, _mm_set1_epi8('_')));
+		matches = _mm_or_si128(matches, _mm_cmpeq_epi8(_block, _mm_set1_epi8('$')));
+		return _mm_movemask_epi8(matches);
+	}
+#endif
+};
+
+/// @returns the index of the first character of @a _text that is in @a _set (or not in it if
+/// @a _inSet is false) or the size of @a _text if there is none. With SSE2, the characters are
+/// tested in blocks of 16.
+template <class Set>
+size_t findFirst(vector_ref<char const> _text, Set const& _set, bool _inSet = true)
+{
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= _text.size(); i += 16)
+	{
+		int mask = _set.contains(_mm_loadu_si128(reinterpret_cast<__m128i const*>(_text.data() + i)));
+		if (!_inSet)
+			mask ^= 0xffff;
+		if (mask)
+			return i + __builtin_ctz(mask);
+	}
+#endif
+	for (; i < _text.size(); ++i)
+		if (_set.contains(_text[i]) == _inSet)
+			break;
+	return i;
+}
+
 } // end anonymous namespace
 
 
@@ -146,7 +234,7 @@ private:
 void Scanner::reset(CharStream const& _source, string const& _sourceName)
 {
 	m_source = _source;
-	m_sourceName = make_shared<string const>(_sourceName);
+	m_sourceID = SourceNames::id(_sourceName);
 	reset();
 }
 
@@ -159,6 +247,13 @@ void Scanner::reset()
 	next();
 }
 
+void Scanner::setPosition(size_t _offset)
+{
+	m_char = m_source.setPosition(_offset);
+	scanToken();
+	next();
+}
+
 bool Scanner::scanHexByte(char& o_scannedByte)
 {
 	char x = 0;
@@ -237,8 +332,13 @@ Token::Value Scanner::selectToken(char _next, Token::Value _then, Token::Value _
 bool Scanner::skipWhitespace()
 {
 	int const startPosition = sourcePos();
-	while (isWhiteSpace(m_char))
+	// The current character is not necessarily the one at the current position, see
+	// skipMultiLineComment.
+	if (isWhiteSpace(m_char))
+	{
 		advance();
+		advance(findFirst(remainingSource(), CharSet{' ', '\n', '\t', '\r'}, false));
+	}
 	// Return whether or not we skipped any characters.
 	return sourcePos() != startPosition;
 }
@@ -246,8 +346,11 @@ bool Scanner::skipWhitespace()
 bool Scanner::skipWhitespaceExceptLF()
 {
 	int const startPosition = sourcePos();
-	while (isWhiteSpace(m_char) && !isLineTerminator(m_char))
+	if (isWhiteSpace(m_char) && !isLineTerminator(m_char))
+	{
 		advance();
+		advance(findFirst(remainingSource(), CharSet{' ', '\t', '\r'}, false));
+	}
 	// Return whether or not we skipped any characters.
 	return sourcePos() != startPosition;
 }
@@ -258,8 +361,7 @@ Token::Value Scanner::skipSingleLineComment()
 	// to be part of the single-line comment; it is recognized
 	// separately by the lexical grammar and becomes part of the
 	// stream of input elements for the syntactic grammar
-	while (!isLineTerminator(m_char))
-		if (!advance()) break;
+	advance(findFirst(remainingSource(), CharSet{'\n'}));
 
 	return Token::Whitespace;
 }
@@ -289,6 +391,7 @@ Token::Value Scanner::scanSingleLineDocComment()
 		}
 		addCommentLiteralChar(m_char);
 		advance();
+		addCommentLiteralAndAdvance(findFirst(remainingSource(), CharSet{'\n'}));
 	}
 	literal.complete();
 	return Token::CommentLiteral;
@@ -299,13 +402,12 @@ Token::Value Scanner::skipMultiLineComment()
 	advance();
 	while (!isSourcePastEndOfInput())
 	{
-		char ch = m_char;
-		advance();
+		advance(findFirst(remainingSource(), CharSet{'*'}));
 
 		// If we have reached the end of the multi-line comment, we
 		// consume the '/' and insert a whitespace. This way all
 		// multi-line comments are treated as whitespace.
-		if (ch == '*' && m_char == '/')
+		if (advance() && m_char == '/')
 		{
 			m_char = ' ';
 			return Token::Whitespace;
@@ -357,6 +459,7 @@ Token::Value Scanner::scanMultiLineDocComment()
 		addCommentLiteralChar(m_char);
 		charsAdded = true;
 		advance();
+		addCommentLiteralAndAdvance(findFirst(remainingSource(), CharSet{'\n', '*'}));
 	}
 	literal.complete();
 	if (!endFound)
@@ -688,15 +791,14 @@ Token::Value Scanner::scanString()
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
 	while (m_char != quote && !isSourcePastEndOfInput() && !isLineTerminator(m_char))
 	{
-		char c = m_char;
-		advance();
-		if (c == '\\')
+		if (m_char == '\\')
 		{
+			advance();
 			if (isSourcePastEndOfInput() || !scanEscape())
 				return Token::Illegal;
 		}
 		else
-			addLiteralChar(c);
+			addLiteralAndAdvance(findFirst(remainingSource(), CharSet{quote, '\\', '\n'}));
 	}
 	if (m_char != quote)
 		return Token::Illegal;
@@ -801,14 +903,18 @@ tuple<Token::Value, unsigned, unsigned> Scanner::scanIdentifierOrKeyword()
 {
 	solAssert(isIdentifierStart(m_char), "");
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
-	addLiteralCharAndAdvance();
-	// Scan the rest of the identifier characters.
-	while (isIdentifierPart(m_char)) //get full literal
-		addLiteralCharAndAdvance();
+	addLiteralAndAdvance(findFirst(remainingSource(), IdentifierPartSet(), false));
 	literal.complete();
 	return Token::fromIdentifierOrKeyword(m_nextToken.literal);
 }
 
+CharStream::CharStream(string _source): m_position(0)
+{
+	auto source = make_shared<string const>(move(_source));
+	m_source = vector_ref<char const>(source->data(), source->size());
+	m_owner = move(source);
+}
+
 char CharStream::advanceAndGet(size_t _chars)
 {
 	if (isPastEndOfInput())
@@ -816,7 +922,14 @@ char CharStream::advanceAndGet(size_t _chars)
 	m_position += _chars;
 	if (isPastEndOfInput())
 		return 0;
-	return m_source[m_position];
+	return m_source.data()[m_position];
+}
+
+char CharStream::setPosition(size_t _location)
+{
+	solAssert(_location <= m_source.size(), "Attempting to set position past end of source.");
+	m_position = _location;
+	return get();
 }
 
 char CharStream::rollback(size_t _amount)
@@ -829,32 +942,24 @@ char CharStream::rollback(size_t _amount)
 string CharStream::lineAtPosition(int _position) const
 {
 	// if _position points to \n, it returns the line before the \n
-	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
-	if (searchStart > 0)
+	char const* searchStart = m_source.begin() + min<size_t>(m_source.size(), _position);
+	if (searchStart > m_source.begin())
 		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
-	if (lineStart == string::npos)
-		lineStart = 0;
-	else
+	char const* lineStart = searchStart;
+	while (lineStart > m_source.begin() && *lineStart != '\n')
+		lineStart--;
+	if (lineStart != m_source.end() && *lineStart == '\n')
 		lineStart++;
-	return m_source.substr(lineStart, min(m_source.find('\n', lineStart),
-										  m_source.size()) - lineStart);
+	return string(lineStart, find(lineStart, m_source.end(), '\n'));
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
-	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
-	size_type lineStart;
-	if (searchPosition == 0)
-		lineStart = 0;
-	else
-	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
-		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
-	}
+	char const* searchPosition = m_source.begin() + min<size_t>(m_source.size(), _position);
+	int lineNumber = count(m_source.begin(), searchPosition, '\n');
+	char const* lineStart = searchPosition;
+	while (lineStart > m_source.begin() && lineStart[-1] != '\n')
+		lineStart--;
 	return tuple<int, int>(lineNumber, searchPosition - lineStart);
 }
 
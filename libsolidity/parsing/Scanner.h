@@ -54,9 +54,12 @@
 
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/vector_ref.h>
 #include <libevmasm/SourceLocation.h>
 #include <libsolidity/parsing/Token.h>
 
+#include <memory>
+
 namespace dev
 {
 namespace solidity
@@ -67,20 +70,36 @@ class AstRawString;
 class AstValueFactory;
 class ParserRecorder;
 
+/**
+ * Read position in an immutable source text. Copies of a stream share the text.
+ */
 class CharStream
 {
 public:
 	CharStream(): m_position(0) {}
-	explicit CharStream(std::string const& _source): m_source(_source), m_position(0) {}
+	/// Creates a stream over @a _source, which is moved into a buffer shared by all copies.
+	explicit CharStream(std::string _source);
+	/// Creates a stream over @a _source without copying it, e.g. over a memory-mapped file or
+	/// a buffer shared with other parts of the compiler. The text is kept alive by @a _owner,
+	/// or by the caller if @a _owner is null, and must not be modified while the stream or
+	/// one of its copies exists.
+	CharStream(vector_ref<char const> _source, std::shared_ptr<void const> _owner):
+		m_owner(std::move(_owner)), m_source(_source), m_position(0) {}
 	int position() const { return m_position; }
 	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	/// @returns the character @a _charsForward characters ahead or zero past the end.
+	char get(size_t _charsForward = 0) const
+	{
+		return isPastEndOfInput(_charsForward) ? 0 : m_source.data()[m_position + _charsForward];
+	}
 	char advanceAndGet(size_t _chars = 1);
 	char rollback(size_t _amount);
+	/// Sets the position to @a _location and @returns the character there.
+	char setPosition(size_t _location);
 
 	void reset() { m_position = 0; }
 
-	std::string const& source() const { return m_source; }
+	vector_ref<char const> source() const { return m_source; }
 
 	///@{
 	///@name Error printing helper functions
@@ -91,7 +110,9 @@ public:
 	///@}
 
 private:
-	std::string m_source;
+	/// Keeps m_source alive, can be null.
+	std::shared_ptr<void const> m_owner;
+	vector_ref<char const> m_source;
 	size_t m_position;
 };
 
@@ -104,12 +125,16 @@ public:
 
 	explicit Scanner(CharStream const& _source = CharStream(), std::string const& _sourceName = "") { reset(_source, _sourceName); }
 
-	std::string source() const { return m_source.source(); }
+	/// @returns the source text, which is valid as long as the scanner is not reset to
+	/// another source.
+	vector_ref<char const> source() const { return m_source.source(); }
 
 	/// Resets the scanner as if newly constructed with _source and _sourceName as input.
 	void reset(CharStream const& _source, std::string const& _sourceName);
 	/// Resets scanner to the start of input.
 	void reset();
+	/// Continues scanning at @a _offset, which has to be the start of a token.
+	void setPosition(size_t _offset);
 
 	/// @returns the next token and advances input
 	Token::Value next();
@@ -154,7 +179,8 @@ public:
 	std::string const& peekLiteral() const { return m_nextToken.literal; }
 	///@}
 
-	std::shared_ptr<std::string const> const& sourceName() const { return m_sourceName; }
+	/// @returns the ID of the source in the SourceNames table.
+	int sourceID() const { return m_sourceID; }
 
 	///@{
 	///@name Error printing helper functions
@@ -179,10 +205,23 @@ private:
 	inline void addLiteralChar(char c) { m_nextToken.literal.push_back(c); }
 	inline void addCommentLiteralChar(char c) { m_nextSkippedComment.literal.push_back(c); }
 	inline void addLiteralCharAndAdvance() { addLiteralChar(m_char); advance(); }
+	/// Adds the next @a _length characters of the source, starting at the current one, to the
+	/// literal and advances past them.
+	inline void addLiteralAndAdvance(size_t _length)
+	{
+		m_nextToken.literal.append(remainingSource().data(), _length);
+		advance(_length);
+	}
+	inline void addCommentLiteralAndAdvance(size_t _length)
+	{
+		m_nextSkippedComment.literal.append(remainingSource().data(), _length);
+		advance(_length);
+	}
 	void addUnicodeAsUTF8(unsigned codepoint);
 	///@}
 
 	bool advance() { m_char = m_source.advanceAndGet(); return !m_source.isPastEndOfInput(); }
+	void advance(size_t _chars) { m_char = m_source.advanceAndGet(_chars); }
 	void rollback(int _amount) { m_char = m_source.rollback(_amount); }
 
 	inline Token::Value selectToken(Token::Value _tok) { advance(); return _tok; }
@@ -221,6 +260,8 @@ private:
 	/// Return the current source position.
 	int sourcePos() const { return m_source.position(); }
 	bool isSourcePastEndOfInput() const { return m_source.isPastEndOfInput(); }
+	/// @returns the source text from the current position on.
+	vector_ref<char const> remainingSource() const { return m_source.source().cropped(sourcePos()); }
 
 	TokenDesc m_skippedComment;  // desc for current skipped comment
 	TokenDesc m_nextSkippedComment; // desc for next skiped comment
@@ -229,7 +270,7 @@ private:
 	TokenDesc m_nextToken;     // desc for next token (one token look-ahead)
 
 	CharStream m_source;
-	std::shared_ptr<std::string const> m_sourceName;
+	int m_sourceID = -1;
 
 	/// one character look-ahead, equals 0 at end of input
 	char m_char;
@@ -40,9 +40,10 @@
 // You should have received a copy of the GNU General Public License
 // along with solidity.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <map>
 #include <libsolidity/parsing/Token.h>
-#include <boost/range/iterator_range.hpp>
+
+#include <cstring>
+#include <vector>
 
 using namespace std;
 
@@ -110,36 +111,125 @@ char const Token::m_tokenType[] =
 	TOKEN_LIST(KT, KK)
 };
 
-int Token::parseSize(string::const_iterator _begin, string::const_iterator _end)
+namespace
+{
+
+bool isDigit(char _c)
+{
+	return '0' <= _c && _c <= '9';
+}
+
+/// Perfect hash table of the keywords, generated from TOKEN_LIST on first use. The seed of the
+/// hash function is chosen such that no two keywords share a slot, so looking up a name only
+/// needs a single comparison with the keyword in its slot.
+class KeywordTable
 {
-	try
+public:
+	static KeywordTable const& instance()
 	{
-		unsigned int m = boost::lexical_cast<int>(boost::make_iterator_range(_begin, _end));
-		return m;
+		static KeywordTable const table;
+		return table;
 	}
-	catch(boost::bad_lexical_cast const&)
+
+	/// @returns the keyword [_begin, _end) or Token::Identifier if it is not a keyword.
+	Token::Value find(char const* _begin, char const* _end) const
+	{
+		size_t length = _end - _begin;
+		Slot const& slot = m_slots[hash(_begin, _end, m_seed)];
+		if (slot.length == length && equal(_begin, _end, Token::toString(slot.token)))
+			return slot.token;
+		return Token::Identifier;
+	}
+
+private:
+	KeywordTable()
 	{
+		// The following macros are used inside TOKEN_LIST and cause non-keyword tokens to be ignored
+		// and keywords to be put inside the keywords variable.
+#define KEYWORD(name, string, precedence) Token::name,
+#define TOKEN(name, string, precedence)
+		vector<Token::Value> const keywords{TOKEN_LIST(TOKEN, KEYWORD)};
+#undef KEYWORD
+#undef TOKEN
+		for (m_seed = 0; !tryFill(keywords); ++m_seed)
+			solAssert(m_seed < 0x10000, "No perfect hash function for the keywords found.");
+	}
+
+	/// Fills the slots using the current seed. @returns false if two keywords share a slot.
+	bool tryFill(vector<Token::Value> const& _keywords)
+	{
+		for (Slot& slot: m_slots)
+			slot = Slot{Token::Identifier, 0};
+		for (Token::Value keyword: _keywords)
+		{
+			char const* name = Token::toString(keyword);
+			size_t length = strlen(name);
+			solAssert(0 < length && length < 0x100, "");
+			Slot& slot = m_slots[hash(name, name + length, m_seed)];
+			if (slot.length != 0)
+				return false;
+			slot = Slot{keyword, uint8_t(length)};
+		}
+		return true;
+	}
+
+	static size_t hash(char const* _begin, char const* _end, uint32_t _seed)
+	{
+		uint32_t h = _seed;
+		for (; _begin != _end; ++_begin)
+			h = (h ^ uint8_t(*_begin)) * 16777619;
+		return (h ^ (h >> 16)) % slotCount;
+	}
+
+	struct Slot
+	{
+		Token::Value token;
+		/// Length of the keyword, zero for an empty slot.
+		uint8_t length;
+	};
+
+	static size_t const slotCount = 1024;
+	Slot m_slots[slotCount];
+	uint32_t m_seed;
+};
+
+}
+
+int Token::parseSize(char const* _begin, char const* _end)
+{
+	if (_begin == _end)
 		return -1;
+	unsigned m = 0;
+	for (; _begin != _end; ++_begin)
+	{
+		if (!isDigit(*_begin))
+			return -1;
+		m = m * 10 + (*_begin - '0');
+		// Larger numbers are no valid sizes anyway.
+		if (m > 0x10000)
+			return -1;
 	}
+	return m;
 }
 
 tuple<Token::Value, unsigned int, unsigned int> Token::fromIdentifierOrKeyword(string const& _literal)
 {
-	auto positionM = find_if(_literal.begin(), _literal.end(), ::isdigit);
-	if (positionM != _literal.end())
+	char const* begin = _literal.data();
+	char const* end = begin + _literal.size();
+	char const* positionM = find_if(begin, end, isDigit);
+	if (positionM != end)
 	{
-		string baseType(_literal.begin(), positionM);
-		auto positionX = find_if_not(positionM, _literal.end(), ::isdigit);
+		char const* positionX = find_if_not(positionM, end, isDigit);
 		int m = parseSize(positionM, positionX);
-		Token::Value keyword = keywordByName(baseType);
+		Token::Value keyword = keywordByName(begin, positionM);
 		if (keyword == Token::Bytes)
 		{
-			if (0 < m && m <= 32 && positionX == _literal.end())
+			if (0 < m && m <= 32 && positionX == end)
 				return make_tuple(Token::BytesM, m, 0);
 		}
 		else if (keyword == Token::UInt || keyword == Token::Int)
 		{
-			if (0 < m && m <= 256 && m % 8 == 0 && positionX == _literal.end())
+			if (0 < m && m <= 256 && m % 8 == 0 && positionX == end)
 			{
 				if (keyword == Token::UInt)
 					return make_tuple(Token::UIntM, m, 0);
@@ -149,13 +239,9 @@ tuple<Token::Value, unsigned int, unsigned int> Token::fromIdentifierOrKeyword(s
 		}
 		else if (keyword == Token::UFixed || keyword == Token::Fixed)
 		{
-			if (
-				positionM < positionX &&
-				positionX < _literal.end() &&
-				*positionX == 'x' &&
-				all_of(positionX + 1, _literal.end(), ::isdigit)
-			) {
-				int n = parseSize(positionX + 1, _literal.end());
+			if (positionX < end && *positionX == 'x')
+			{
+				int n = parseSize(positionX + 1, end);
 				if (
 					8 <= m && m <= 256 && m % 8 == 0 &&
 					0 <= n && n <= 80
@@ -165,24 +251,17 @@ tuple<Token::Value, unsigned int, unsigned int> Token::fromIdentifierOrKeyword(s
 					else
 						return make_tuple(Token::FixedMxN, m, n);
 				}
-			}	
+			}
 		}
 		return make_tuple(Token::Identifier, 0, 0);
 	}
 
-	return make_tuple(keywordByName(_literal), 0, 0);
+	return make_tuple(keywordByName(begin, end), 0, 0);
 }
-Token::Value Token::keywordByName(string const& _name)
+
+Token::Value Token::keywordByName(char const* _begin, char const* _end)
 {
-	// The following macros are used inside TOKEN_LIST and cause non-keyword tokens to be ignored
-	// and keywords to be put inside the keywords variable.
-#define KEYWORD(name, string, precedence) {string, Token::name},
-#define TOKEN(name, string, precedence)
-	static const map<string, Token::Value> keywords({TOKEN_LIST(TOKEN, KEYWORD)});
-#undef KEYWORD
-#undef TOKEN
-	auto it = keywords.find(_name);
-	return it == keywords.end() ? Token::Identifier : it->second;
+	return KeywordTable::instance().find(_begin, _end);
 }
 
 #undef KT
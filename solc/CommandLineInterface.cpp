@@ -32,6 +32,8 @@
 #include <libsolidity/ast/ASTJsonConverter.h>
 #include <libsolidity/analysis/NameAndTypeResolver.h>
 #include <libsolidity/interface/Exceptions.h>
+#include <libsolidity/interface/CompilationCache.h>
+#include <libsolidity/interface/CompilerServer.h>
 #include <libsolidity/interface/CompilerStack.h>
 #include <libsolidity/interface/StandardCompiler.h>
 #include <libsolidity/interface/SourceReferenceFormatter.h>
@@ -49,6 +51,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/asio.hpp>
 
 #ifdef _WIN32 // windows
 	#include <io.h>
@@ -57,9 +60,15 @@
 #else // unix
 	#include <unistd.h>
 #endif
+#include <csignal>
 #include <string>
+#include <iomanip>
+#include <list>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 namespace po = boost::program_options;
@@ -79,9 +88,11 @@ static string const g_strAst = "ast";
 static string const g_strAstJson = "ast-json";
 static string const g_strAstCompactJson = "ast-compact-json";
 static string const g_strBinary = "bin";
+static string const g_strCacheDir = "cache-dir";
 static string const g_strBinaryRuntime = "bin-runtime";
 static string const g_strCloneBinary = "clone-bin";
 static string const g_strCombinedJson = "combined-json";
+static string const g_strCompilationThreads = "compilation-threads";
 static string const g_strCompactJSON = "compact-format";
 static string const g_strContracts = "contracts";
 static string const g_strEVM = "evm";
@@ -107,7 +118,12 @@ static string const g_strOptimize = "optimize";
 static string const g_strOptimizeRuns = "optimize-runs";
 static string const g_strOutputDir = "output-dir";
 static string const g_strOverwrite = "overwrite";
+static string const g_strServer = "server";
+static string const g_strServerCacheSize = "server-cache-size";
+static string const g_strServerSocket = "server-socket";
+static string const g_strServerThreads = "server-threads";
 static string const g_strSignatureHashes = "hashes";
+static string const g_strTimePasses = "time-passes";
 static string const g_strSources = "sources";
 static string const g_strSourceList = "sourceList";
 static string const g_strSrcMap = "srcmap";
@@ -129,9 +145,11 @@ static string const g_argAstCompactJson = g_strAstCompactJson;
 static string const g_argAstJson = g_strAstJson;
 static string const g_argBinary = g_strBinary;
 static string const g_argBinaryRuntime = g_strBinaryRuntime;
+static string const g_argCacheDir = g_strCacheDir;
 static string const g_argCloneBinary = g_strCloneBinary;
 static string const g_argCombinedJson = g_strCombinedJson;
 static string const g_argCompactJSON = g_strCompactJSON;
+static string const g_argCompilationThreads = g_strCompilationThreads;
 static string const g_argFormal = g_strFormal;
 static string const g_argGas = g_strGas;
 static string const g_argHelp = g_strHelp;
@@ -148,7 +166,12 @@ static string const g_argOpcodes = g_strOpcodes;
 static string const g_argOptimize = g_strOptimize;
 static string const g_argOptimizeRuns = g_strOptimizeRuns;
 static string const g_argOutputDir = g_strOutputDir;
+static string const g_argServer = g_strServer;
+static string const g_argServerCacheSize = g_strServerCacheSize;
+static string const g_argServerSocket = g_strServerSocket;
+static string const g_argServerThreads = g_strServerThreads;
 static string const g_argSignatureHashes = g_strSignatureHashes;
+static string const g_argTimePasses = g_strTimePasses;
 static string const g_argStandardJSON = g_strStandardJSON;
 static string const g_argStrictAssembly = g_strStrictAssembly;
 static string const g_argVersion = g_strVersion;
@@ -228,6 +251,183 @@ static bool needsHumanTargetedStdout(po::variables_map const& _args)
 	return false;
 }
 
+/// @returns true if any requested output is based on assembly items, which are not
+/// available for contracts loaded from the compilation cache.
+static bool needsAssemblyItems(po::variables_map const& _args)
+{
+	if (_args.count(g_argAsm) || _args.count(g_argAsmJson) || _args.count(g_argAst))
+		return true;
+	if (_args.count(g_argCombinedJson))
+	{
+		set<string> requests;
+		boost::split(requests, _args[g_argCombinedJson].as<string>(), boost::is_any_of(","));
+		return requests.count(g_strAsm) > 0;
+	}
+	return false;
+}
+
+/// Serves the connections to the Unix domain socket at @a _path, each on its own thread,
+/// until SIGINT or SIGTERM is received or accepting a connection fails. On shutdown, the
+/// requests that were already received are answered and the socket file is removed.
+/// @returns false if the socket could not be set up or accepting a connection failed.
+static bool serveUnixSocket(CompilerServer& _server, string const& _path)
+{
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+	using boost::asio::local::stream_protocol;
+	// Clients closing their connections early must not terminate the server.
+	signal(SIGPIPE, SIG_IGN);
+
+	struct Connection
+	{
+		shared_ptr<stream_protocol::socket> socket;
+		thread worker;
+		bool finished = false;
+	};
+
+	boost::asio::io_service ioService;
+	boost::asio::signal_set signals(ioService, SIGINT, SIGTERM);
+	unique_ptr<stream_protocol::acceptor> acceptor;
+	try
+	{
+		acceptor.reset(new stream_protocol::acceptor(ioService, stream_protocol::endpoint(_path)));
+	}
+	catch (boost::system::system_error const& _error)
+	{
+		cerr << "Compiler server error: " << _error.what() << endl;
+		return false;
+	}
+
+	bool success = true;
+	mutex connectionsMutex;
+	list<Connection> connections;
+
+	auto serveConnection = [&](Connection& _connection)
+	{
+		stream_protocol::socket& socket = *_connection.socket;
+		try
+		{
+			// Responses are written on a different thread, which needs a socket object of its own.
+			stream_protocol::socket writeSocket(ioService, stream_protocol(), ::dup(socket.native_handle()));
+			boost::asio::streambuf buffer;
+			_server.serve(
+				[&](string& _request)
+				{
+					boost::system::error_code error;
+					boost::asio::read_until(socket, buffer, '\n', error);
+					if (error && buffer.size() == 0)
+						return false;
+					istream input(&buffer);
+					getline(input, _request);
+					return true;
+				},
+				[&](string const& _response)
+				{
+					boost::system::error_code error;
+					boost::asio::write(writeSocket, boost::asio::buffer(_response + "\n"), error);
+				}
+			);
+		}
+		catch (boost::system::system_error const&)
+		{
+		}
+		lock_guard<mutex> lock(connectionsMutex);
+		boost::system::error_code error;
+		socket.close(error);
+		_connection.finished = true;
+	};
+
+	function<void()> acceptNext = [&]()
+	{
+		auto socket = make_shared<stream_protocol::socket>(ioService);
+		acceptor->async_accept(*socket, [&, socket](boost::system::error_code const& _error)
+		{
+			if (_error == boost::asio::error::operation_aborted)
+				return;
+			if (_error)
+			{
+				cerr << "Compiler server error: " << _error.message() << endl;
+				success = false;
+				signals.cancel();
+				return;
+			}
+			lock_guard<mutex> lock(connectionsMutex);
+			// Threads of closed connections are joined, so they do not pile up.
+			for (auto it = connections.begin(); it != connections.end();)
+				if (it->finished)
+				{
+					it->worker.join();
+					it = connections.erase(it);
+				}
+				else
+					++it;
+			connections.emplace_back();
+			Connection& connection = connections.back();
+			connection.socket = socket;
+			connection.worker = thread(serveConnection, ref(connection));
+			acceptNext();
+		});
+	};
+	signals.async_wait([&](boost::system::error_code const& _error, int)
+	{
+		if (!_error)
+			acceptor->close();
+	});
+	acceptNext();
+	ioService.run();
+
+	{
+		// Stop reading new requests. The requests already read are still answered.
+		lock_guard<mutex> lock(connectionsMutex);
+		for (Connection& connection: connections)
+			if (!connection.finished)
+				::shutdown(connection.socket->native_handle(), SHUT_RD);
+	}
+	for (Connection& connection: connections)
+		connection.worker.join();
+	acceptor.reset();
+	boost::system::error_code error;
+	boost::filesystem::remove(_path, error);
+	return success;
+#else
+	(void)_server;
+	(void)_path;
+	cerr << "Unix domain sockets are not supported on this platform." << endl;
+	return false;
+#endif
+}
+
+static void printTimings(Timings const& _timings)
+{
+	ostringstream output;
+	output << endl << "======= Timings =======" << endl << fixed << setprecision(3);
+	for (auto const& unit: _timings.measurements())
+	{
+		output << (unit.first.empty() ? "All sources" : unit.first) << ":" << endl;
+		for (auto const& phase: unit.second)
+		{
+			output << "  " << phase.first << ": " << phase.second.seconds * 1000 << " ms";
+			output << " (" << phase.second.count << (phase.second.count == 1 ? " run" : " runs");
+			if (phase.second.peakMemoryIncrease > 0)
+				output << ", peak memory +" << phase.second.peakMemoryIncrease / 1024 << " kB";
+			output << ")" << endl;
+		}
+	}
+	cerr << output.str();
+}
+
+static bool needsCloneObjects(po::variables_map const& _args)
+{
+	if (_args.count(g_argCloneBinary))
+		return true;
+	if (_args.count(g_argCombinedJson))
+	{
+		set<string> requests;
+		boost::split(requests, _args[g_argCombinedJson].as<string>(), boost::is_any_of(","));
+		return requests.count(g_strCloneBinary) > 0;
+	}
+	return false;
+}
+
 void CommandLineInterface::handleBinary(string const& _contract)
 {
 	if (m_args.count(g_argBinary))
@@ -566,6 +766,17 @@ Allowed options)",
 			po::value<unsigned>()->value_name("n")->default_value(200),
 			"Estimated number of contract runs for optimizer tuning."
 		)
+		(
+			g_argCompilationThreads.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(1),
+			"Number of threads used to parse sources, to generate code for independent contracts and to optimise their sub-assemblies in parallel."
+		)
+		(
+			g_argCacheDir.c_str(),
+			po::value<string>()->value_name("path"),
+			"Directory in which compilation results are cached to speed up repeated compilations "
+			"of unchanged contracts. Not used if assembly output is requested."
+		)
 		(g_argPrettyJson.c_str(), "Output JSON in pretty format. Currently it only works with the combined JSON output.")
 		(
 			g_argLibraries.c_str(),
@@ -586,11 +797,37 @@ Allowed options)",
 			"Output a single json document containing the specified information."
 		)
 		(g_argGas.c_str(), "Print an estimate of the maximal gas usage for each function.")
+		(
+			g_argTimePasses.c_str(),
+			"Print the time spent in each compiler phase per source and contract to standard error."
+		)
 		(
 			g_argStandardJSON.c_str(),
 			"Switch to Standard JSON input / output mode, ignoring all options. "
 			"It reads from standard input and provides the result on the standard output."
 		)
+		(
+			g_argServer.c_str(),
+			"Switch to compiler server mode, ignoring all options except --allow-paths, --cache-dir "
+			"and the --server-* options. It reads Standard JSON inputs, one per line, from standard input "
+			"or the socket given by --server-socket and provides the results in the same order, one per line. "
+			"Compilation results are cached in memory across inputs."
+		)
+		(
+			g_argServerSocket.c_str(),
+			po::value<string>()->value_name("path"),
+			"Unix domain socket on which the compiler server accepts connections instead of using standard input."
+		)
+		(
+			g_argServerThreads.c_str(),
+			po::value<unsigned>()->value_name("n")->default_value(4),
+			"Number of inputs the compiler server compiles concurrently."
+		)
+		(
+			g_argServerCacheSize.c_str(),
+			po::value<unsigned>()->value_name("MiB")->default_value(512),
+			"Memory the compiler server uses at most to cache compilation results."
+		)
 		(
 			g_argAssemble.c_str(),
 			"Switch to assembly mode, ignoring all options except --machine and assumes input is assembly."
@@ -695,7 +932,8 @@ Allowed options)",
 
 bool CommandLineInterface::processInput()
 {
-	ReadCallback::Callback fileReader = [this](string const& _path)
+	// Does not record the files it reads, so it can be used concurrently.
+	ReadCallback::Callback readAllowedFile = [this](string const& _path)
 	{
 		try
 		{
@@ -722,9 +960,7 @@ bool CommandLineInterface::processInput()
 				return ReadCallback::Result{false, "Not a valid file."};
 			else
 			{
-				auto contents = dev::readFileAsString(canonicalPath.string());
-				m_sourceCodes[path.string()] = contents;
-				return ReadCallback::Result{true, contents};
+				return ReadCallback::Result{true, dev::readFileAsString(canonicalPath.string())};
 			}
 		}
 		catch (Exception const& _exception)
@@ -736,6 +972,13 @@ bool CommandLineInterface::processInput()
 			return ReadCallback::Result{false, "Unknown exception in read callback."};
 		}
 	};
+	ReadCallback::Callback fileReader = [&](string const& _path)
+	{
+		ReadCallback::Result result = readAllowedFile(_path);
+		if (result.success)
+			m_sourceCodes[boost::filesystem::path(_path).string()] = result.responseOrErrorMessage;
+		return result;
+	};
 
 	if (m_args.count(g_argAllowPaths))
 	{
@@ -753,10 +996,29 @@ bool CommandLineInterface::processInput()
 		}
 	}
 
+	if (m_args.count(g_argServer))
+	{
+		// Inputs are compiled concurrently and the files they import are not kept.
+		CompilerServer server(
+			readAllowedFile,
+			m_args[g_argServerThreads].as<unsigned>(),
+			make_shared<CompilationCache>(
+				m_args.count(g_argCacheDir) ? m_args[g_argCacheDir].as<string>() : string(),
+				size_t(m_args[g_argServerCacheSize].as<unsigned>()) * 1024 * 1024
+			)
+		);
+		if (m_args.count(g_argServerSocket))
+			return serveUnixSocket(server, m_args[g_argServerSocket].as<string>());
+		server.serve(cin, cout);
+		return true;
+	}
+
 	if (m_args.count(g_argStandardJSON))
 	{
 		string input = dev::readStandardInput();
 		StandardCompiler compiler(fileReader);
+		if (m_args.count(g_argCacheDir))
+			compiler.setCompilationCache(make_shared<CompilationCache>(m_args[g_argCacheDir].as<string>()));
 		cout << compiler.compile(input) << endl;
 		return true;
 	}
@@ -824,8 +1086,13 @@ bool CommandLineInterface::processInput()
 			m_compiler->useMetadataLiteralSources(true);
 		if (m_args.count(g_argInputFile))
 			m_compiler->setRemappings(m_args[g_argInputFile].as<vector<string>>());
+		// The sources are not modified while compiling and outlive the compiler, so it can use
+		// them without copying.
 		for (auto const& sourceCode: m_sourceCodes)
-			m_compiler->addSource(sourceCode.first, sourceCode.second);
+			m_compiler->addSource(
+				sourceCode.first,
+				CharStream(vector_ref<char const>(sourceCode.second.data(), sourceCode.second.size()), nullptr)
+			);
 		if (m_args.count(g_argLibraries))
 			m_compiler->setLibraries(m_libraries);
 		m_compiler->setEVMVersion(m_evmVersion);
@@ -833,6 +1100,16 @@ bool CommandLineInterface::processInput()
 		bool optimize = m_args.count(g_argOptimize) > 0;
 		unsigned runs = m_args[g_argOptimizeRuns].as<unsigned>();
 		m_compiler->setOptimiserSettings(optimize, runs);
+		m_compiler->setCompilationThreads(m_args[g_argCompilationThreads].as<unsigned>());
+		m_compiler->setRequestedOutputs(true, needsCloneObjects(m_args));
+		if (m_args.count(g_argCacheDir) && !needsAssemblyItems(m_args))
+			m_compiler->setCompilationCache(
+				make_shared<CompilationCache>(m_args[g_argCacheDir].as<string>()),
+				m_args.count(g_argGas) > 0
+			);
+
+		if (m_args.count(g_argTimePasses))
+			m_compiler->useTimings(true);
 
 		bool successful = m_compiler->compile();
 
@@ -842,6 +1119,9 @@ bool CommandLineInterface::processInput()
 				(error->type() == Error::Type::Warning) ? "Warning" : "Error"
 			);
 
+		if (Timings const* timings = m_compiler->timings())
+			printTimings(*timings);
+
 		if (!successful)
 			return false;
 	}
@@ -1036,7 +1316,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 bool CommandLineInterface::actOnInput()
 {
-	if (m_args.count(g_argStandardJSON) || m_onlyAssemble)
+	if (m_args.count(g_argStandardJSON) || m_args.count(g_argServer) || m_onlyAssemble)
 		// Already done in "processInput" phase.
 		return true;
 	else if (m_onlyLink)
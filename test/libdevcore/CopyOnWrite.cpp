@@ -0,0 +1,75 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for CopyOnWrite.
+ */
+
+#include <libdevcore/CopyOnWrite.h>
+
+#include <test/Options.h>
+
+#include <map>
+
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(CopyOnWriteTest)
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+	CopyOnWrite<map<int, int>> a;
+	CopyOnWrite<map<int, int>> b;
+	BOOST_CHECK(a->empty());
+	BOOST_CHECK(a.sharesWith(b));
+}
+
+BOOST_AUTO_TEST_CASE(copies_share_until_modified)
+{
+	CopyOnWrite<map<int, int>> a;
+	a.mutate()[1] = 2;
+	CopyOnWrite<map<int, int>> b = a;
+	BOOST_CHECK(a.sharesWith(b));
+
+	b.mutate()[3] = 4;
+	BOOST_CHECK(!a.sharesWith(b));
+	BOOST_CHECK_EQUAL(a->size(), 1);
+	BOOST_CHECK_EQUAL(b->size(), 2);
+	BOOST_CHECK_EQUAL(b->at(1), 2);
+
+	// Not shared anymore, so no further copy is made.
+	map<int, int> const* value = &*b;
+	b.mutate()[5] = 6;
+	BOOST_CHECK_EQUAL(&*b, value);
+}
+
+BOOST_AUTO_TEST_CASE(reset)
+{
+	CopyOnWrite<map<int, int>> a(map<int, int>{{1, 2}});
+	CopyOnWrite<map<int, int>> b = a;
+	a.reset();
+	BOOST_CHECK(a->empty());
+	BOOST_CHECK_EQUAL(b->size(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
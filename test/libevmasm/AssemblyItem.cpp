@@ -0,0 +1,144 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for assembly items, in particular for data that is stored inline or on the heap.
+ */
+
+#include <libevmasm/AssemblyItem.h>
+
+#include <test/Options.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+u256 const maxInline = numeric_limits<uint64_t>::max();
+
+/// Values around the largest value that is stored inline.
+vector<u256> boundaryValues()
+{
+	return {0, 1, maxInline - 1, maxInline, maxInline + 1, maxInline + 2, u256(1) << 128, ~u256(0)};
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(AssemblyItemTest)
+
+BOOST_AUTO_TEST_CASE(data)
+{
+	for (u256 const& value: boundaryValues())
+	{
+		BOOST_CHECK_EQUAL(AssemblyItem(value).data(), value);
+		BOOST_CHECK_EQUAL(AssemblyItem(PushData, value).data(), value);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(set_data)
+{
+	// Every value replaces every other value, so the data moves between inline and heap
+	// storage in both directions.
+	for (u256 const& from: boundaryValues())
+		for (u256 const& to: boundaryValues())
+		{
+			AssemblyItem item(Push, from);
+			item.setData(to);
+			BOOST_CHECK_EQUAL(item.data(), to);
+			BOOST_CHECK(item == AssemblyItem(Push, to));
+		}
+}
+
+BOOST_AUTO_TEST_CASE(copy_and_move)
+{
+	for (u256 const& value: boundaryValues())
+	{
+		AssemblyItem item(Push, value);
+		AssemblyItem copy = item;
+		BOOST_CHECK(copy == item);
+		// Changing the copy does not change the original, even if the data is shared.
+		copy.setData(value + 1);
+		BOOST_CHECK_EQUAL(copy.data(), value + 1);
+		BOOST_CHECK_EQUAL(item.data(), value);
+
+		copy = item;
+		BOOST_CHECK_EQUAL(copy.data(), value);
+		AssemblyItem moved = std::move(copy);
+		BOOST_CHECK_EQUAL(moved.data(), value);
+		moved = AssemblyItem(Push, maxInline + 1 - value);
+		BOOST_CHECK_EQUAL(moved.data(), maxInline + 1 - value);
+		BOOST_CHECK_EQUAL(item.data(), value);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(comparison)
+{
+	vector<u256> values = boundaryValues();
+	for (u256 const& a: values)
+		for (u256 const& b: values)
+		{
+			AssemblyItem itemA(Push, a);
+			AssemblyItem itemB(Push, b);
+			BOOST_CHECK_EQUAL(itemA == itemB, a == b);
+			BOOST_CHECK_EQUAL(itemA != itemB, a != b);
+			BOOST_CHECK_EQUAL(itemA < itemB, a < b);
+		}
+
+	// Items are ordered by type first.
+	BOOST_CHECK(AssemblyItem(Push, ~u256(0)) < AssemblyItem(PushTag, 0));
+	BOOST_CHECK(!(AssemblyItem(PushTag, 0) < AssemblyItem(Push, ~u256(0))));
+	BOOST_CHECK(AssemblyItem(Push, maxInline + 1) != AssemblyItem(PushData, maxInline + 1));
+
+	vector<AssemblyItem> items;
+	for (u256 const& value: values)
+		items.push_back(AssemblyItem(Push, value));
+	reverse(items.begin(), items.end());
+	sort(items.begin(), items.end());
+	for (size_t i = 0; i < items.size(); ++i)
+		BOOST_CHECK_EQUAL(items[i].data(), values[i]);
+}
+
+BOOST_AUTO_TEST_CASE(foreign_push_tags)
+{
+	AssemblyItem tag(PushTag, 5);
+	BOOST_CHECK(tag.splitForeignPushTag() == make_pair(size_t(-1), size_t(5)));
+	// Tags of sub-assemblies do not fit into the inline data.
+	AssemblyItem foreign = tag.toSubAssemblyTag(3);
+	BOOST_CHECK(foreign.splitForeignPushTag() == make_pair(size_t(3), size_t(5)));
+	BOOST_CHECK(foreign != tag);
+	BOOST_CHECK(tag < foreign);
+	foreign.setPushTagSubIdAndTag(0, 7);
+	BOOST_CHECK(foreign.splitForeignPushTag() == make_pair(size_t(0), size_t(7)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
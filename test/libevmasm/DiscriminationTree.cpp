@@ -0,0 +1,288 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the index over the patterns of simplification rules.
+ */
+
+#include <libevmasm/DiscriminationTree.h>
+#include <libevmasm/ExpressionClasses.h>
+#include <libevmasm/RuleList.h>
+#include <libevmasm/SimplificationRules.h>
+
+#include <test/Options.h>
+
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+using Symbol = DiscriminationTree::Symbol;
+
+/// Expression or pattern as a tree of symbols.
+struct Term
+{
+	Symbol symbol;
+	vector<Term> arguments;
+};
+
+Term op(Instruction _instruction, vector<Term> const& _arguments = {})
+{
+	return Term{Symbol::operation(_instruction), _arguments};
+}
+Term constant(u256 const& _value) { return Term{Symbol::constant(_value), {}}; }
+Term anyConstant() { return Term{Symbol::anyConstant(), {}}; }
+Term any() { return Term{Symbol::any(), {}}; }
+
+void appendSymbols(Term const& _term, vector<Symbol>& _symbols)
+{
+	_symbols.push_back(_term.symbol);
+	for (Term const& argument: _term.arguments)
+		appendSymbols(argument, _symbols);
+}
+
+vector<Symbol> symbols(Term const& _pattern)
+{
+	vector<Symbol> result;
+	appendSymbols(_pattern, result);
+	return result;
+}
+
+vector<size_t> candidates(DiscriminationTree const& _tree, Term const& _expression)
+{
+	vector<Term const*> pending;
+	vector<size_t> result;
+	_tree.candidates(
+		&_expression,
+		[](Term const* _term) { return _term->symbol; },
+		[](Term const* _term, vector<Term const*>& _arguments)
+		{
+			for (Term const& argument: _term->arguments)
+				_arguments.push_back(&argument);
+		},
+		pending,
+		result
+	);
+	return result;
+}
+
+/// Matches @a _pattern against @a _expression directly, which is what the tree has to agree with.
+bool matches(Term const& _pattern, Term const& _expression)
+{
+	switch (_pattern.symbol.kind)
+	{
+	case Symbol::Kind::Any:
+		return true;
+	case Symbol::Kind::AnyConstant:
+		return _expression.symbol.kind == Symbol::Kind::Constant;
+	case Symbol::Kind::Constant:
+		return _expression.symbol.kind == Symbol::Kind::Constant && _expression.symbol.value == _pattern.symbol.value;
+	case Symbol::Kind::Operation:
+		if (_expression.symbol.kind != Symbol::Kind::Operation || _expression.symbol.instruction != _pattern.symbol.instruction)
+			return false;
+		for (size_t i = 0; i < _pattern.arguments.size(); ++i)
+			if (!matches(_pattern.arguments[i], _expression.arguments[i]))
+				return false;
+		return true;
+	}
+	return false;
+}
+
+/// @returns a random expression or, if @a _pattern is true, a random pattern of at most
+/// @a _depth levels.
+Term randomTerm(mt19937& _random, unsigned _depth, bool _pattern)
+{
+	static Instruction const instructions[] = {Instruction::ADD, Instruction::AND, Instruction::NOT, Instruction::ISZERO};
+	unsigned choice = _random() % (_depth > 0 ? 7 : 3);
+	if (choice == 0)
+		return constant(u256(_random() % 3));
+	else if (choice == 1)
+		return _pattern ? anyConstant() : constant(u256(3));
+	else if (choice == 2)
+		return any();
+	Instruction instruction = instructions[_random() % 4];
+	vector<Term> arguments;
+	for (int i = 0; i < instructionInfo(instruction).args; ++i)
+		arguments.push_back(randomTerm(_random, _depth - 1, _pattern));
+	return op(instruction, arguments);
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(DiscriminationTreeTest)
+
+BOOST_AUTO_TEST_CASE(exact_and_wildcard_matches)
+{
+	DiscriminationTree tree;
+	tree.insert(symbols(op(Instruction::ADD, {anyConstant(), any()})), 0);
+	tree.insert(symbols(op(Instruction::ADD, {constant(0), any()})), 1);
+	tree.insert(symbols(op(Instruction::ADD, {any(), any()})), 2);
+	tree.insert(symbols(op(Instruction::NOT, {op(Instruction::NOT, {any()})})), 3);
+	tree.insert(symbols(op(Instruction::ISZERO, {constant(1)})), 4);
+
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {constant(0), any()})) == vector<size_t>{0, 1, 2}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {constant(5), any()})) == vector<size_t>{0, 2}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {any(), constant(0)})) == vector<size_t>{2}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {op(Instruction::NOT, {any()}), constant(0)})) == vector<size_t>{2}));
+	BOOST_CHECK((candidates(tree, op(Instruction::NOT, {op(Instruction::NOT, {constant(0)})})) == vector<size_t>{3}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ISZERO, {constant(1)})) == vector<size_t>{4}));
+}
+
+BOOST_AUTO_TEST_CASE(no_match)
+{
+	DiscriminationTree tree;
+	BOOST_CHECK(candidates(tree, op(Instruction::ADD, {constant(0), any()})).empty());
+
+	tree.insert(symbols(op(Instruction::NOT, {op(Instruction::NOT, {any()})})), 0);
+	tree.insert(symbols(op(Instruction::ISZERO, {constant(1)})), 1);
+	BOOST_CHECK(candidates(tree, op(Instruction::NOT, {constant(0)})).empty());
+	BOOST_CHECK(candidates(tree, op(Instruction::ISZERO, {constant(2)})).empty());
+	BOOST_CHECK(candidates(tree, op(Instruction::ISZERO, {any()})).empty());
+	BOOST_CHECK(candidates(tree, op(Instruction::MUL, {constant(1), constant(1)})).empty());
+	BOOST_CHECK(candidates(tree, constant(1)).empty());
+	BOOST_CHECK(candidates(tree, any()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(rule_order)
+{
+	// Candidates are returned in the order of the rules, not in the order their paths are
+	// visited, and rules with equal patterns are all returned.
+	DiscriminationTree tree;
+	tree.insert(symbols(op(Instruction::ADD, {constant(0), constant(0)})), 0);
+	tree.insert(symbols(op(Instruction::ADD, {any(), any()})), 1);
+	tree.insert(symbols(op(Instruction::ADD, {anyConstant(), constant(0)})), 2);
+	tree.insert(symbols(op(Instruction::ADD, {any(), any()})), 3);
+	tree.insert(symbols(op(Instruction::ADD, {constant(0), anyConstant()})), 4);
+
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {constant(0), constant(0)})) == vector<size_t>{0, 1, 2, 3, 4}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {constant(0), constant(1)})) == vector<size_t>{1, 3, 4}));
+	BOOST_CHECK((candidates(tree, op(Instruction::ADD, {any(), constant(0)})) == vector<size_t>{1, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(same_as_linear_matching)
+{
+	mt19937 random(1);
+	vector<Term> patterns;
+	DiscriminationTree tree;
+	for (size_t i = 0; i < 200; ++i)
+	{
+		patterns.push_back(randomTerm(random, 3, true));
+		tree.insert(symbols(patterns.back()), i);
+	}
+	for (size_t i = 0; i < 2000; ++i)
+	{
+		Term expression = randomTerm(random, 4, false);
+		vector<size_t> expectation;
+		for (size_t j = 0; j < patterns.size(); ++j)
+			if (matches(patterns[j], expression))
+				expectation.push_back(j);
+		BOOST_REQUIRE(candidates(tree, expression) == expectation);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(same_as_linear_matching_of_rules)
+{
+	// Finds the first matching simplification rule by trying all rules in order, which is
+	// how the rules were matched before they were indexed.
+	MatchGroups<ExpressionClasses::Expression> matchGroups{};
+	Pattern A(Push);
+	Pattern B(Push);
+	Pattern C(Push);
+	Pattern X;
+	Pattern Y;
+	A.setMatchGroup(1, matchGroups);
+	B.setMatchGroup(2, matchGroups);
+	C.setMatchGroup(3, matchGroups);
+	X.setMatchGroup(4, matchGroups);
+	Y.setMatchGroup(5, matchGroups);
+	auto ruleList = simplificationRuleList(A, B, C, X, Y);
+
+	vector<Instruction> instructions;
+	for (auto const& rule: ruleList)
+		instructions.push_back(rule.pattern.instruction());
+	u256 const constants[] = {0, 1, 2, 0xff, 0x100, u256(1) << 160, ~u256(0)};
+
+	// The classes are simplified already, so the expressions to match are built on top of them.
+	mt19937 random(1);
+	ExpressionClasses classes;
+	vector<ExpressionClasses::Id> ids;
+	for (u256 const& value: constants)
+		ids.push_back(classes.find(AssemblyItem(value)));
+	ids.push_back(classes.find(AssemblyItem(Instruction::CALLER)));
+	ids.push_back(classes.newClass(SourceLocation()));
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		Instruction instruction = instructions[random() % instructions.size()];
+		ExpressionClasses::Ids arguments;
+		for (int j = 0; j < instructionInfo(instruction).args; ++j)
+			arguments.push_back(ids[random() % ids.size()]);
+		ids.push_back(classes.find(AssemblyItem(instruction), arguments));
+	}
+
+	Rules rules;
+	size_t matched = 0;
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		AssemblyItem item(instructions[random() % instructions.size()]);
+		ExpressionClasses::Ids arguments;
+		for (int j = 0; j < item.arguments(); ++j)
+			arguments.push_back(ids[random() % ids.size()]);
+		ExpressionClasses::Expression expression;
+		expression.id = classes.size();
+		expression.item = &item;
+		expression.arguments = vector_ref<ExpressionClasses::Id const>(arguments.data(), arguments.size());
+
+		SimplificationRule<Pattern> const* expectation = nullptr;
+		for (auto const& rule: ruleList)
+		{
+			matchGroups.fill(nullptr);
+			if (rule.pattern.matches(expression, classes))
+			{
+				expectation = &rule;
+				break;
+			}
+		}
+		SimplificationRule<Pattern> const* match = rules.findFirstMatch(expression, classes);
+		BOOST_REQUIRE_EQUAL(!!match, !!expectation);
+		if (!match)
+			continue;
+		matched++;
+		BOOST_CHECK_EQUAL(match->pattern.toString(), expectation->pattern.toString());
+		BOOST_CHECK_EQUAL(match->removesNonConstants, expectation->removesNonConstants);
+		BOOST_CHECK_EQUAL(
+			ExpressionTemplate(match->action(), SourceLocation()).toString(),
+			ExpressionTemplate(expectation->action(), SourceLocation()).toString()
+		);
+	}
+	BOOST_CHECK(matched > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
@@ -0,0 +1,129 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the classes of equivalent expressions.
+ */
+
+#include <libevmasm/ExpressionClasses.h>
+
+#include <test/Options.h>
+
+#include <vector>
+
+using namespace std;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(ExpressionClassesTest)
+
+BOOST_AUTO_TEST_CASE(identical_expressions)
+{
+	ExpressionClasses classes;
+	ExpressionClasses::Id caller = classes.find(AssemblyItem(Instruction::CALLER));
+	ExpressionClasses::Id address = classes.find(AssemblyItem(Instruction::ADDRESS));
+	BOOST_CHECK(caller != address);
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(Instruction::CALLER)), caller);
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(u256(7))), classes.find(AssemblyItem(u256(7))));
+
+	ExpressionClasses::Id sub = classes.find(AssemblyItem(Instruction::SUB), {caller, address});
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(Instruction::SUB), {caller, address}), sub);
+	BOOST_CHECK(classes.find(AssemblyItem(Instruction::SUB), {address, caller}) != sub);
+	// The arguments of commutative operations are sorted.
+	ExpressionClasses::Id add = classes.find(AssemblyItem(Instruction::ADD), {caller, address});
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(Instruction::ADD), {address, caller}), add);
+	BOOST_CHECK(add != sub);
+}
+
+BOOST_AUTO_TEST_CASE(many_expressions)
+{
+	// Enough expressions for the hash table to grow several times.
+	ExpressionClasses classes;
+	ExpressionClasses::Id caller = classes.find(AssemblyItem(Instruction::CALLER));
+	vector<ExpressionClasses::Id> ids;
+	for (unsigned i = 0; i < 5000; ++i)
+		ids.push_back(classes.find(
+			AssemblyItem(Instruction::SUB),
+			{caller, classes.find(AssemblyItem(u256(i) + 0x100))}
+		));
+	ExpressionClasses::Id size = classes.size();
+	for (unsigned i = 0; i < 5000; ++i)
+		BOOST_REQUIRE_EQUAL(
+			classes.find(AssemblyItem(Instruction::SUB), {caller, classes.find(AssemblyItem(u256(i) + 0x100))}),
+			ids[i]
+		);
+	BOOST_CHECK_EQUAL(classes.size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(reset)
+{
+	ExpressionClasses classes;
+	ExpressionClasses::Id caller = classes.find(AssemblyItem(Instruction::CALLER));
+	ExpressionClasses::Id address = classes.find(AssemblyItem(Instruction::ADDRESS));
+	classes.find(AssemblyItem(Instruction::SUB), {caller, address});
+	BOOST_CHECK_EQUAL(classes.size(), 3);
+
+	classes.reset();
+	BOOST_CHECK_EQUAL(classes.size(), 0);
+	// The same ids now refer to other expressions. The expressions of the older generation
+	// must not be found anymore, otherwise SUB would be found although the expression it
+	// referred to is gone.
+	address = classes.find(AssemblyItem(Instruction::ADDRESS));
+	caller = classes.find(AssemblyItem(Instruction::CALLER));
+	BOOST_CHECK_EQUAL(classes.size(), 2);
+	ExpressionClasses::Id sub = classes.find(AssemblyItem(Instruction::SUB), {address, caller});
+	BOOST_CHECK_EQUAL(classes.size(), 3);
+	ExpressionClasses::Expression const& expression = classes.representative(sub);
+	BOOST_REQUIRE(expression.item);
+	BOOST_CHECK(*expression.item == AssemblyItem(Instruction::SUB));
+	BOOST_REQUIRE_EQUAL(expression.arguments.size(), 2);
+	BOOST_CHECK_EQUAL(expression.arguments[0], address);
+	BOOST_CHECK_EQUAL(expression.arguments[1], caller);
+	BOOST_CHECK_EQUAL(classes.find(AssemblyItem(Instruction::SUB), {address, caller}), sub);
+}
+
+BOOST_AUTO_TEST_CASE(new_class_after_reset)
+{
+	ExpressionClasses classes;
+	for (unsigned i = 0; i < 1000; ++i)
+	{
+		ExpressionClasses::Id caller = classes.find(AssemblyItem(Instruction::CALLER));
+		ExpressionClasses::Id unknown = classes.newClass(SourceLocation());
+		BOOST_REQUIRE(unknown != caller);
+		BOOST_REQUIRE_EQUAL(classes.size(), 2);
+		BOOST_REQUIRE_EQUAL(classes.representative(unknown).item->type(), UndefinedItem);
+		// The new class is different from everything, including a second new class.
+		ExpressionClasses::Id other = classes.newClass(SourceLocation());
+		BOOST_REQUIRE(other != unknown);
+		BOOST_REQUIRE(
+			classes.find(AssemblyItem(Instruction::ADD), {unknown, caller}) !=
+			classes.find(AssemblyItem(Instruction::ADD), {other, caller})
+		);
+		classes.reset();
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
@@ -27,11 +27,13 @@
 #include <libevmasm/JumpdestRemover.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/BlockDeduplicator.h>
+#include <libevmasm/ConstantOptimiser.h>
 #include <libevmasm/Assembly.h>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <functional>
 #include <string>
 #include <tuple>
 #include <memory>
@@ -53,7 +55,7 @@ namespace
 		// add dummy locations to each item so that we can check that they are not deleted
 		AssemblyItems input = _input;
 		for (AssemblyItem& item: input)
-			item.setLocation(SourceLocation(1, 3, make_shared<string>("")));
+			item.setLocation(SourceLocation(1, 3, SourceNames::id("")));
 		return input;
 	}
 
@@ -784,6 +786,29 @@ BOOST_AUTO_TEST_CASE(block_deduplicator_loops)
 	BOOST_CHECK_EQUAL(pushTags.size(), 1);
 }
 
+BOOST_AUTO_TEST_CASE(block_deduplicator_similar_blocks)
+{
+	// The blocks only differ in the high bits of a pushed value.
+	AssemblyItems input{
+		AssemblyItem(PushTag, 1),
+		AssemblyItem(PushTag, 2),
+		AssemblyItem(PushTag, 3),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(1) << 200,
+		Instruction::STOP,
+		AssemblyItem(Tag, 2),
+		u256(2) << 200,
+		Instruction::STOP,
+		AssemblyItem(Tag, 3),
+		u256(1) << 200,
+		Instruction::STOP
+	};
+	BlockDeduplicator dedup(input);
+	BOOST_CHECK(dedup.deduplicate());
+	BOOST_CHECK((dedup.replacedTags() == map<u256, u256>{{3, 1}}));
+}
+
 BOOST_AUTO_TEST_CASE(clear_unreachable_code)
 {
 	AssemblyItems items{
@@ -853,9 +878,63 @@ BOOST_AUTO_TEST_CASE(peephole_pop_calldatasize)
 		Instruction::POP
 	};
 	PeepholeOptimiser peepOpt(items);
-	for (size_t i = 0; i < 3; i++)
-		BOOST_CHECK(peepOpt.optimise());
+	BOOST_CHECK(peepOpt.optimise());
 	BOOST_CHECK(items.empty());
+	BOOST_CHECK(!peepOpt.optimise());
+}
+
+BOOST_AUTO_TEST_CASE(peephole_cascade)
+{
+	// Every rewrite enables one before it, so all of them are only found by revisiting
+	// the items in front of a change.
+	AssemblyItems items{
+		AssemblyItem(PushTag, 1),
+		Instruction::JUMP,
+		AssemblyItem(Tag, 1),
+		u256(1),
+		u256(2),
+		Instruction::SWAP1,
+		Instruction::SWAP1,
+		Instruction::ADD,
+		Instruction::POP,
+		u256(4),
+		u256(4)
+	};
+	AssemblyItems expectation{
+		AssemblyItem(Tag, 1),
+		u256(4),
+		Instruction::DUP1
+	};
+	PeepholeOptimiser peepOpt(items);
+	BOOST_REQUIRE(peepOpt.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		expectation.begin(), expectation.end()
+	);
+	BOOST_CHECK(!peepOpt.optimise());
+}
+
+BOOST_AUTO_TEST_CASE(peephole_no_growth)
+{
+	// Replacing ADDMOD and POP by three POPs would grow the code since the arguments
+	// are not pushed right before.
+	AssemblyItems items{
+		Instruction::CALLVALUE,
+		Instruction::CALLDATASIZE,
+		Instruction::GAS,
+		Instruction::ADDMOD,
+		Instruction::POP,
+		Instruction::MULMOD,
+		Instruction::POP
+	};
+	AssemblyItems original = items;
+	PeepholeOptimiser peepOpt(items);
+	BOOST_CHECK(!peepOpt.optimise());
+	BOOST_CHECK_EQUAL_COLLECTIONS(
+		items.begin(), items.end(),
+		original.begin(), original.end()
+	);
+	BOOST_CHECK_LE(bytesRequired(items, 3), bytesRequired(original, 3));
 }
 
 BOOST_AUTO_TEST_CASE(jumpdest_removal)
@@ -941,6 +1020,86 @@ BOOST_AUTO_TEST_CASE(jumpdest_removal_subassemblies)
 	);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_subassembly_optimisation)
+{
+	// Nested sub-assemblies with tags referenced from their super-assemblies
+	// are optimised in the same way on any number of threads.
+	// @returns the assembly and the tag referenced from its super-assembly.
+	function<pair<AssemblyPointer, AssemblyItem>(unsigned)> createAssembly = [&](unsigned _depth)
+	{
+		AssemblyPointer assembly = make_shared<Assembly>();
+		for (unsigned i = 0; _depth > 0 && i < 3; ++i)
+		{
+			auto sub = createAssembly(_depth - 1);
+			size_t subId = size_t(assembly->appendSubroutine(sub.first).data());
+			assembly->append(sub.second.toSubAssemblyTag(subId));
+		}
+		assembly->append(u256(1));
+		auto t1 = assembly->newTag();
+		assembly->append(t1);
+		assembly->append(u256(2));
+		assembly->append(Instruction::JUMP);
+		assembly->append(assembly->newTag());
+		assembly->append(u256(2));
+		assembly->append(Instruction::JUMP);
+		assembly->append(assembly->newTag());
+		assembly->append(u256(3));
+		assembly->append(u256(4));
+		assembly->append(Instruction::ADD);
+		assembly->append(t1.pushTag());
+		assembly->append(Instruction::JUMP);
+		return make_pair(assembly, t1);
+	};
+	AssemblyPointer parallel = createAssembly(3).first;
+	AssemblyPointer serial = parallel->deepCopy();
+	serial->optimise(true, dev::test::Options::get().evmVersion(), true, 200, 1);
+	parallel->optimise(true, dev::test::Options::get().evmVersion(), true, 200, 4);
+	BOOST_CHECK_EQUAL(parallel->assemblyString(), serial->assemblyString());
+	BOOST_CHECK(parallel->assemble().bytecode == serial->assemble().bytecode);
+}
+
+BOOST_AUTO_TEST_CASE(optimiser_pass_statistics)
+{
+	Assembly assembly;
+	for (AssemblyItem const& item: AssemblyItems{
+		// Simplified by the common subexpression eliminator.
+		u256(1), u256(2), Instruction::ADD, u256(0), Instruction::SSTORE,
+		u256(0), u256(0), u256(0), Instruction::CALLDATACOPY,
+		// Not changed by any pass.
+		Instruction::CALLVALUE, u256(1), Instruction::SSTORE,
+		Instruction::STOP
+	})
+		assembly.append(item);
+
+	vector<Assembly::OptimiserPassStatistics> statistics;
+	Assembly::OptimiserSettings settings;
+	settings.runPeephole = true;
+	settings.runCSE = true;
+	settings.evmVersion = dev::test::Options::get().evmVersion();
+	settings.statistics = [&](Assembly::OptimiserPassStatistics const& _statistics)
+	{
+		statistics.push_back(_statistics);
+	};
+	assembly.optimise(settings);
+
+	// The first iteration changes the code and the second one finds nothing to do.
+	BOOST_REQUIRE_EQUAL(statistics.size(), 4);
+	for (size_t i = 0; i < statistics.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(statistics[i].pass, i % 2 ? "CommonSubexpressionEliminator" : "PeepholeOptimiser");
+		BOOST_CHECK_EQUAL(statistics[i].iteration, i / 2 + 1);
+	}
+	BOOST_CHECK(statistics[1].changed);
+	BOOST_CHECK_LT(statistics[1].itemsAfter, statistics[1].itemsBefore);
+	BOOST_CHECK(!statistics[2].changed);
+	BOOST_CHECK(!statistics[3].changed);
+	// Only the block changed in the first iteration is looked at again.
+	BOOST_CHECK_EQUAL(statistics[1].blocks, 2);
+	BOOST_CHECK_EQUAL(statistics[1].skippedBlocks, 0);
+	BOOST_CHECK_EQUAL(statistics[3].blocks, 2);
+	BOOST_CHECK_EQUAL(statistics[3].skippedBlocks, 1);
+}
+
 BOOST_AUTO_TEST_CASE(cse_sub_zero)
 {
 	checkCSE({
@@ -963,6 +1122,39 @@ BOOST_AUTO_TEST_CASE(cse_sub_zero)
 	});
 }
 
+BOOST_AUTO_TEST_CASE(constant_optimiser_step_limit_and_memo)
+{
+	ConstantOptimisationMethod::Params params;
+	params.isCreation = false;
+	params.runs = 1;
+	params.multiplicity = 1;
+	params.evmVersion = dev::test::Options::get().evmVersion();
+	Assembly assembly;
+	u256 value = (u256(3) << 240) - (u256(1) << 120) + 77;
+	ComputeMethod::Memo memo;
+	AssemblyItems computed = ComputeMethod(params, value, &memo).execute(assembly);
+	BOOST_CHECK(computed.size() > 1);
+	BOOST_CHECK(!memo.empty());
+
+	// Without any steps, only the literal is considered, unless the representation is memoised.
+	AssemblyItems literal{value};
+	AssemblyItems withoutSteps = ComputeMethod(params, value, nullptr, 0).execute(assembly);
+	BOOST_CHECK_EQUAL_COLLECTIONS(withoutSteps.begin(), withoutSteps.end(), literal.begin(), literal.end());
+	AssemblyItems memoised = ComputeMethod(params, value, &memo, 0).execute(assembly);
+	BOOST_CHECK_EQUAL_COLLECTIONS(memoised.begin(), memoised.end(), computed.begin(), computed.end());
+
+	// Values with many gaps have lots of decompositions into parts with gaps themselves. The
+	// search stops after the given number of steps, and results of searches cut short are not
+	// memoised.
+	u256 gaps = 0;
+	for (unsigned i = 0; i < 28; ++i)
+		gaps = (gaps << 9) | (i % 2 ? 0x1ff : 0x100);
+	ComputeMethod::Memo gapsMemo;
+	ComputeMethod(params, gaps, &gapsMemo, 1);
+	BOOST_CHECK(gapsMemo.empty());
+	ComputeMethod(params, gaps, &gapsMemo);
+	BOOST_CHECK(!gapsMemo.empty());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
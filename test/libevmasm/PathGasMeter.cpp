@@ -0,0 +1,96 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Unit tests for the path based gas estimation.
+ */
+
+#include <libevmasm/PathGasMeter.h>
+#include <libevmasm/KnownState.h>
+
+#include <test/Options.h>
+
+using namespace std;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+/// @returns code with @a _branches conditional jumps, each of them skipping @a _skipped,
+/// so the number of paths through the code is exponential in @a _branches.
+AssemblyItems branches(size_t _branches, AssemblyItems const& _skipped)
+{
+	AssemblyItems items;
+	for (size_t i = 0; i < _branches; ++i)
+	{
+		items.push_back(u256(i));
+		items.push_back(Instruction::CALLDATALOAD);
+		items.push_back(AssemblyItem(PushTag, i + 1));
+		items.push_back(Instruction::JUMPI);
+		items.insert(items.end(), _skipped.begin(), _skipped.end());
+		items.push_back(AssemblyItem(Tag, i + 1));
+	}
+	items.push_back(Instruction::STOP);
+	return items;
+}
+
+GasMeter::GasConsumption estimate(AssemblyItems const& _items, size_t _maxSteps = PathGasMeter::defaultMaxSteps)
+{
+	PathGasMeter meter(_items, dev::test::Options::get().evmVersion(), _maxSteps);
+	return meter.estimateMax(0, make_shared<KnownState>());
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(PathGasMeterTest)
+
+BOOST_AUTO_TEST_CASE(merge_equal_states)
+{
+	// Both paths through each branch end in the same state, so they are merged without
+	// losing precision.
+	AssemblyItems skipped{u256(1), Instruction::POP};
+	GasMeter::GasConsumption single = estimate(branches(1, skipped));
+	GasMeter::GasConsumption gas = estimate(branches(64, skipped));
+	BOOST_REQUIRE(!single.isInfinite);
+	BOOST_REQUIRE(!gas.isInfinite);
+	BOOST_CHECK_EQUAL(gas.value, 64 * single.value);
+}
+
+BOOST_AUTO_TEST_CASE(step_budget)
+{
+	// The paths through each branch end in different states, so they are only merged once the
+	// budget is exceeded. The result is still an upper bound of the exact estimate.
+	AssemblyItems skipped{u256(1), u256(2), Instruction::SSTORE};
+	GasMeter::GasConsumption exact = estimate(branches(10, skipped));
+	GasMeter::GasConsumption bounded = estimate(branches(10, skipped), 100);
+	BOOST_REQUIRE(!exact.isInfinite);
+	BOOST_CHECK(bounded.isInfinite || exact.value <= bounded.value);
+	// Without merging, there would be 2^64 paths.
+	BOOST_CHECK(!estimate(branches(64, skipped), 1000).isInfinite);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
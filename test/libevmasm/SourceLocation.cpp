@@ -24,6 +24,8 @@
 
 #include <test/Options.h>
 
+#include <thread>
+
 namespace dev
 {
 namespace solidity
@@ -35,12 +37,49 @@ BOOST_AUTO_TEST_SUITE(SourceLocationTest)
 
 BOOST_AUTO_TEST_CASE(test_fail)
 {
+	// Registered in reverse order, locations are still ordered by source name.
+	int sourceB = SourceNames::id("sourceB");
+	int sourceA = SourceNames::id("sourceA");
+	int source = SourceNames::id("source");
 	BOOST_CHECK(SourceLocation() == SourceLocation());
-	BOOST_CHECK(SourceLocation(0, 3, std::make_shared<std::string>("sourceA")) != SourceLocation(0, 3, std::make_shared<std::string>("sourceB")));
-	BOOST_CHECK(SourceLocation(0, 3, std::make_shared<std::string>("source")) == SourceLocation(0, 3, std::make_shared<std::string>("source")));
-	BOOST_CHECK(SourceLocation(3, 7, std::make_shared<std::string>("source")).contains(SourceLocation(4, 6, std::make_shared<std::string>("source"))));
-	BOOST_CHECK(!SourceLocation(3, 7, std::make_shared<std::string>("sourceA")).contains(SourceLocation(4, 6, std::make_shared<std::string>("sourceB"))));
-	BOOST_CHECK(SourceLocation(3, 7, std::make_shared<std::string>("sourceA")) < SourceLocation(4, 6, std::make_shared<std::string>("sourceB")));
+	BOOST_CHECK(SourceLocation(0, 3, sourceA) != SourceLocation(0, 3, sourceB));
+	BOOST_CHECK(SourceLocation(0, 3, source) == SourceLocation(0, 3, source));
+	BOOST_CHECK(SourceLocation(3, 7, source).contains(SourceLocation(4, 6, source)));
+	BOOST_CHECK(!SourceLocation(3, 7, sourceA).contains(SourceLocation(4, 6, sourceB)));
+	BOOST_CHECK(SourceLocation(3, 7, sourceA) < SourceLocation(4, 6, sourceB));
+	BOOST_CHECK(SourceLocation(4, 6, sourceA) < SourceLocation(3, 7, sourceB));
+	BOOST_CHECK(SourceLocation(3, 7, sourceB) < SourceLocation(4, 6, sourceB));
+	BOOST_CHECK(SourceLocation() < SourceLocation(0, 1, sourceB));
+}
+
+BOOST_AUTO_TEST_CASE(source_names)
+{
+	int id = SourceNames::id("source_names.sol");
+	BOOST_CHECK(id >= 0);
+	BOOST_CHECK_EQUAL(SourceNames::id("source_names.sol"), id);
+	BOOST_CHECK(SourceNames::id("other_source_names.sol") != id);
+	BOOST_CHECK_EQUAL(SourceNames::name(id), "source_names.sol");
+	BOOST_CHECK_EQUAL(*SourceLocation(0, 1, id).sourceName(), "source_names.sol");
+	BOOST_CHECK(!SourceLocation().sourceName());
+}
+
+BOOST_AUTO_TEST_CASE(source_names_concurrent)
+{
+	// Names are read while other names are added, which moves on to new chunks.
+	int first = SourceNames::id("concurrent_0.sol");
+	std::thread writer([]()
+	{
+		for (size_t i = 1; i < 1000; ++i)
+			SourceNames::id("concurrent_" + std::to_string(i) + ".sol");
+	});
+	for (size_t i = 0; i < 1000; ++i)
+		BOOST_REQUIRE_EQUAL(SourceNames::name(first), "concurrent_0.sol");
+	writer.join();
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		std::string name = "concurrent_" + std::to_string(i) + ".sol";
+		BOOST_REQUIRE_EQUAL(SourceNames::name(SourceNames::id(name)), name);
+	}
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,8 +24,13 @@
 
 #include <libsolidity/interface/Exceptions.h>
 #include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/interface/CompilationCache.h>
 #include <libsolidity/ast/ASTJsonConverter.h>
 
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <string>
@@ -296,6 +301,163 @@ BOOST_AUTO_TEST_CASE(documentation)
 }
 
 
+BOOST_AUTO_TEST_CASE(parallel_parsing_assigns_same_ids)
+{
+	map<string, string> importedSources{
+		{"x", "import {Y as Z} from \"y\"; contract X is Z { function f() { uint[] memory a; a[0] = 1; } }"},
+		{"y", "contract Y { event E(uint indexed a); function g() returns (uint) { assembly { mstore(0, 1) } } }"}
+	};
+	ReadCallback::Callback readFile = [&](string const& _path)
+	{
+		return ReadCallback::Result{importedSources.count(_path) > 0, importedSources.count(_path) ? importedSources.at(_path) : ""};
+	};
+	auto parse = [&](unsigned _threads)
+	{
+		CompilerStack c(readFile);
+		c.addSource("a", "import \"x\"; contract A is X { mapping(uint => Z) m; }");
+		c.addSource("b", "/// Documentation\ncontract B { function h(uint x) pure returns (uint) { return x * 2 ether; } }");
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		c.setCompilationThreads(_threads);
+		BOOST_REQUIRE(c.parseAndAnalyze());
+		map<string, Json::Value> asts;
+		for (string const& name: c.sourceNames())
+			asts[name] = ASTJsonConverter(false, c.sourceIndices()).toJson(c.ast(name));
+		return asts;
+	};
+	map<string, Json::Value> serial = parse(1);
+	BOOST_CHECK_EQUAL(serial.size(), 4);
+	for (unsigned threads: {2u, 4u})
+		BOOST_CHECK(parse(threads) == serial);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_round_trip)
+{
+	map<string, string> importedSources{
+		{"lib", R"(
+			pragma solidity >=0.4.0;
+			/// @title Library
+			library L {
+				struct S { uint a; bytes32[2] b; mapping(address => bool) m; }
+				enum E { One, Two }
+				event Ev(uint indexed a, string b) anonymous;
+				/// @notice Adds.
+				function add(uint a, uint b) internal pure returns (uint) { return a + b; }
+			}
+		)"}
+	};
+	ReadCallback::Callback readFile = [&](string const& _path)
+	{
+		return ReadCallback::Result{importedSources.count(_path) > 0, importedSources.count(_path) ? importedSources.at(_path) : ""};
+	};
+	char const* sourceCode = R"(
+		import {L as Lib} from "lib";
+		import "lib" as lib;
+		contract Base { function Base(uint) public {} }
+		contract C is Base(7) {
+			using Lib for uint;
+			uint constant c = 2 days + 1 ether;
+			function(uint) external returns (uint) fp;
+			Lib.S s;
+			event Log(bytes data);
+			modifier m(uint x) { require(x > 0); _; }
+			function() public payable { }
+			function f(uint a) public m(a) returns (uint r, bool) {
+				var (x, y) = (a, "\x00\nA");
+				uint[3] memory arr = [uint(1), 2, 0x0f];
+				if (a == 1) throw; else if (a > 2) { r = a.add(1); }
+				while (a < 10) { a += 2; if (a == 6) continue; if (a == 8) break; }
+				do { a--; } while (a > 20);
+				for (uint i = 0; i < 3; ++i) arr[i] = !(i != 0) ? i ** 2 : -int(i) >= 0 ? 1 : 2;
+				new Base(a);
+				delete arr;
+				emit Log(hex"00ff");
+				assembly { let t := mload(0x40) mstore(t, r) }
+				bytes memory b = bytes(y);
+				return (x + b.length, address(this).balance > 0);
+			}
+		}
+	)";
+	boost::filesystem::path cacheDirectory =
+		boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("solc-cache-%%%%-%%%%-%%%%");
+	auto analyse = [&](shared_ptr<CompilationCache> const& _cache, unsigned _threads)
+	{
+		CompilerStack c(readFile);
+		c.addSource("a", sourceCode);
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		c.setCompilationCache(_cache);
+		c.setCompilationThreads(_threads);
+		BOOST_REQUIRE(c.parseAndAnalyze());
+		vector<string> results;
+		for (string const& name: c.sourceNames())
+		{
+			results.push_back(jsonCompactPrint(ASTJsonConverter(false, c.sourceIndices()).toJson(c.ast(name))));
+			results.push_back(jsonCompactPrint(ASTJsonConverter(true, c.sourceIndices()).toJson(c.ast(name))));
+		}
+		for (auto const& error: c.errors())
+			results.push_back(error->typeName() + ": " + *boost::get_error_info<errinfo_comment>(*error));
+		return results;
+	};
+	vector<string> reference = analyse(nullptr, 1);
+	auto cache = make_shared<CompilationCache>(cacheDirectory.string());
+	BOOST_CHECK(analyse(cache, 1) == reference);
+	size_t snapshots = 0;
+	for (auto const& entry: boost::filesystem::directory_iterator(cacheDirectory))
+		if (entry.path().extension() == ".ast")
+			snapshots++;
+	BOOST_CHECK_EQUAL(snapshots, 2);
+	// Now rebuilt from the snapshots.
+	BOOST_CHECK(analyse(cache, 1) == reference);
+	BOOST_CHECK(analyse(cache, 2) == reference);
+
+	// Snapshots that cannot be read are ignored.
+	for (auto const& entry: boost::filesystem::directory_iterator(cacheDirectory))
+		if (entry.path().extension() == ".ast")
+		{
+			string snapshot = readFileAsString(entry.path().string());
+			writeFile(entry.path().string(), snapshot.substr(0, snapshot.size() / 2));
+		}
+	BOOST_CHECK(analyse(cache, 1) == reference);
+
+	boost::filesystem::remove_all(cacheDirectory);
+}
+
+BOOST_AUTO_TEST_CASE(ast_arena)
+{
+	auto analyse = [](bool _astArena)
+	{
+		CompilerStack c;
+		c.addSource("a", "contract C { uint x; function f(uint a) public returns (uint) { return a + x; } }");
+		c.setEVMVersion(dev::test::Options::get().evmVersion());
+		c.useASTArena(_astArena);
+		BOOST_REQUIRE(c.parseAndAnalyze());
+		return jsonCompactPrint(ASTJsonConverter(false, c.sourceIndices()).toJson(c.ast("a")));
+	};
+	BOOST_CHECK_EQUAL(analyse(true), analyse(false));
+
+	// Resetting releases the ASTs and their arenas but keeps the sources.
+	CompilerStack c;
+	c.addSource("a", "contract C { uint x; function f(uint a) public returns (uint) { return a + x; } }");
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.parseAndAnalyze());
+	string json = jsonCompactPrint(ASTJsonConverter(false, c.sourceIndices()).toJson(c.ast("a")));
+	c.reset(true);
+	BOOST_CHECK_THROW(c.ast("a"), CompilerError);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	BOOST_REQUIRE(c.parseAndAnalyze());
+	BOOST_CHECK_EQUAL(jsonCompactPrint(ASTJsonConverter(false, c.sourceIndices()).toJson(c.ast("a"))), json);
+
+	// Nodes keep their arena alive.
+	shared_ptr<Identifier> identifier;
+	{
+		auto arena = make_shared<ASTArena>();
+		ASTNode::ArenaScope scope(arena);
+		identifier = ASTNode::create<Identifier>(SourceLocation(), make_shared<ASTString>("x"));
+		identifier->annotation().isLValue = true;
+	}
+	BOOST_CHECK_EQUAL(identifier->name(), "x");
+	BOOST_CHECK(identifier->annotation().isLValue);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
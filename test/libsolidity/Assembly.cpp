@@ -102,8 +102,8 @@ void printAssemblyLocations(AssemblyItems const& _items)
 			_loc.start <<
 			", " <<
 			_loc.end <<
-			", make_shared<string>(\"" <<
-			*_loc.sourceName <<
+			", SourceNames::id(\"" <<
+			(_loc.sourceName() ? *_loc.sourceName() : "") <<
 			"\"))) +" << endl;
 	};
 
@@ -157,7 +157,7 @@ BOOST_AUTO_TEST_CASE(location_test)
 		}
 	}
 	)";
-	shared_ptr<string const> n = make_shared<string>("");
+	int n = SourceNames::id("");
 	AssemblyItems items = compileContract(sourceCode);
 	vector<SourceLocation> locations =
 		vector<SourceLocation>(24, SourceLocation(2, 75, n)) +
@@ -0,0 +1,120 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2018
+ * Unit tests for interface/CompilerServer.h.
+ */
+
+#include <libsolidity/interface/CompilationCache.h>
+#include <libsolidity/interface/CompilerServer.h>
+#include <libsolidity/interface/StandardCompiler.h>
+
+#include <libdevcore/SHA3.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+string request(string const& _source)
+{
+	return
+		"{\"language\": \"Solidity\", \"sources\": {\"a.sol\": {\"content\": \"" + _source + "\"}},"
+		" \"settings\": {\"outputSelection\": {\"*\": {\"*\": [\"evm.bytecode.object\", \"abi\"], \"\": [\"ast\"]}}}}";
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(CompilerServerTests)
+
+BOOST_AUTO_TEST_CASE(responses_in_order)
+{
+	vector<string> requests{
+		request("contract A { function f() returns (uint) { return 1; } }"),
+		"not json",
+		request("contract B { function g() returns (uint) { return 2; } }"),
+		request("contract C is D {}"),
+		request("contract A { function f() returns (uint) { return 1; } }")
+	};
+	string input;
+	for (size_t i = 0; i < 8; ++i)
+		for (string const& r: requests)
+			input += r + "\n\n";
+
+	vector<string> expectation;
+	for (size_t i = 0; i < 8; ++i)
+		for (string const& r: requests)
+			expectation.push_back(StandardCompiler().compile(r));
+
+	auto cache = make_shared<CompilationCache>(string(), 1024 * 1024);
+	CompilerServer server(ReadCallback::Callback(), 4, cache);
+	istringstream inputStream(input);
+	ostringstream outputStream;
+	server.serve(inputStream, outputStream);
+	vector<string> responses;
+	string output = outputStream.str();
+	boost::split(responses, output, boost::is_any_of("\n"));
+	BOOST_REQUIRE(!responses.empty() && responses.back().empty());
+	responses.pop_back();
+	BOOST_CHECK(responses == expectation);
+	BOOST_CHECK(cache->memoryUsage() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(memory_cache_eviction)
+{
+	CompilationCache cache(string(), 100);
+	auto entry = [](size_t _value)
+	{
+		Json::Value value(Json::objectValue);
+		value["data"] = string(30, 'a' + _value);
+		return value;
+	};
+	for (size_t i = 0; i < 3; ++i)
+		cache.store(keccak256(to_string(i)), entry(i));
+	BOOST_CHECK(cache.memoryUsage() <= 100);
+	BOOST_CHECK(cache.load(keccak256("0")).isNull());
+	BOOST_CHECK(cache.load(keccak256("1")) == entry(1));
+	// Entry 2 is now the least recently used one.
+	cache.store(keccak256("3"), entry(3));
+	BOOST_CHECK(cache.load(keccak256("2")).isNull());
+	BOOST_CHECK(cache.load(keccak256("1")) == entry(1));
+	BOOST_CHECK(cache.load(keccak256("3")) == entry(3));
+
+	bytes snapshot(200, 7);
+	cache.storeSnapshot(keccak256("large"), snapshot);
+	BOOST_CHECK(!cache.readSnapshot(keccak256("large"), [](bytesConstRef) {}));
+	BOOST_CHECK(cache.memoryUsage() <= 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
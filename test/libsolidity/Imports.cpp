@@ -316,6 +316,49 @@ BOOST_AUTO_TEST_CASE(shadowing_builtins_with_alias)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(incremental_analysis)
+{
+	CompilerStack c;
+	c.useIncrementalAnalysis(true);
+	c.setEVMVersion(dev::test::Options::get().evmVersion());
+	c.addSource("a", "contract A { function f() {} } pragma solidity >=0.0;");
+	c.addSource("b", "import \"a\"; contract B is A { function g() { uint x; } } pragma solidity >=0.0;");
+	c.addSource("c", "import \"b\"; contract C is B {} pragma solidity >=0.0;");
+	c.addSource("d", "contract D {} pragma solidity >=0.0;");
+	BOOST_REQUIRE(c.compile());
+	SourceUnit const* a = &c.ast("a");
+	SourceUnit const* b = &c.ast("b");
+	SourceUnit const* d = &c.ast("d");
+	size_t warnings = c.errors().size();
+
+	// Only the changed source and the sources importing it are analysed again,
+	// the warnings of unchanged sources are retained.
+	c.addSource("b", "import \"a\"; contract B is A { function g() { uint y; } } pragma solidity >=0.0;");
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK(&c.ast("a") == a);
+	BOOST_CHECK(&c.ast("b") != b);
+	BOOST_CHECK(&c.ast("d") == d);
+	BOOST_CHECK_EQUAL(c.errors().size(), warnings);
+	BOOST_CHECK(!c.object("C").bytecode.empty());
+
+	// Errors are reported for the changed source.
+	c.addSource("a", "contract A { function f() { g(); } } pragma solidity >=0.0;");
+	BOOST_CHECK(!c.parseAndAnalyze());
+	BOOST_CHECK(Error::containsErrorOfType(c.errors(), Error::Type::DeclarationError));
+	BOOST_CHECK(&c.ast("d") == d);
+
+	c.addSource("a", "contract A { function f() {} } pragma solidity >=0.0;");
+	BOOST_REQUIRE(c.compile());
+	BOOST_CHECK_EQUAL(c.errors().size(), warnings);
+
+	// Adding an unchanged source does not cause any analysis.
+	b = &c.ast("b");
+	c.addSource("b", "import \"a\"; contract B is A { function g() { uint y; } } pragma solidity >=0.0;");
+	BOOST_REQUIRE(c.parseAndAnalyze());
+	BOOST_CHECK(&c.ast("b") == b);
+	BOOST_CHECK_EQUAL(c.errors().size(), warnings);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
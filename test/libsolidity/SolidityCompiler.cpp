@@ -22,6 +22,12 @@
 
 #include <test/Options.h>
 
+#include <libsolidity/interface/CompilationCache.h>
+
+#include <boost/filesystem.hpp>
+
+#include <thread>
+
 using namespace std;
 
 namespace dev
@@ -53,6 +59,160 @@ BOOST_AUTO_TEST_CASE(does_not_include_creation_time_only_internal_functions)
 	BOOST_CHECK(runtimeBytecode.size() <= 70);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_compilation_is_deterministic)
+{
+	char const* sourceCode = R"(
+		contract A { uint x; function f() { x = 1; } }
+		contract B { A a = new A(); function g() { a.f(); } }
+		contract C { B b = new B(); A a = new A(); }
+		contract D is C { function h() returns (uint) { return 7; } }
+		contract E { function k() { new D(); } }
+		contract Abstract { function f(); function g() { new X(); } }
+		contract F is Abstract { function f() {} }
+		contract X { }
+	)";
+	auto compile = [&](unsigned _threads)
+	{
+		map<string, bytes> objects;
+		CompilerStack compiler;
+		compiler.addSource("", sourceCode);
+		compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		compiler.setOptimiserSettings(dev::test::Options::get().optimize);
+		compiler.setCompilationThreads(_threads);
+		BOOST_REQUIRE_MESSAGE(compiler.compile(), "Compiling contract failed");
+		for (string const& name: compiler.contractNames())
+		{
+			objects[name + ".object"] = compiler.object(name).bytecode;
+			objects[name + ".runtime"] = compiler.runtimeObject(name).bytecode;
+			objects[name + ".clone"] = compiler.cloneObject(name).bytecode;
+		}
+		return objects;
+	};
+	map<string, bytes> serial = compile(1);
+	BOOST_CHECK(!serial.at(":E.object").empty());
+	BOOST_CHECK(serial.at(":Abstract.object").empty());
+	BOOST_CHECK(!serial.at(":F.object").empty());
+	for (unsigned threads: {2u, 4u, 16u})
+		BOOST_CHECK(compile(threads) == serial);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_clone_objects)
+{
+	char const* sourceCode = R"(
+		contract A { uint x; function f() { x = 1; } }
+		contract B { A a = new A(); function g() { a.f(); } }
+		contract C { function h() returns (uint) { return 7; } }
+	)";
+	CompilerStack compiler;
+	compiler.addSource("", sourceCode);
+	compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+	compiler.setOptimiserSettings(dev::test::Options::get().optimize);
+	BOOST_REQUIRE_MESSAGE(compiler.compile(), "Compiling contract failed");
+	vector<string> names = compiler.contractNames();
+	// The clone objects are generated on demand by whichever thread asks first.
+	vector<vector<eth::LinkerObject const*>> objects(8);
+	vector<thread> threads;
+	for (auto& threadObjects: objects)
+		threads.emplace_back([&]()
+		{
+			for (string const& name: names)
+				threadObjects.push_back(&compiler.cloneObject(name));
+		});
+	for (thread& t: threads)
+		t.join();
+	for (auto const& threadObjects: objects)
+		BOOST_CHECK(threadObjects == objects.front());
+	for (eth::LinkerObject const* object: objects.front())
+		BOOST_CHECK(!object->bytecode.empty());
+}
+
+BOOST_AUTO_TEST_CASE(compilation_cache)
+{
+	char const* sourceCode = R"(
+		library L { function f() returns (uint) { return 1; } }
+		contract A { function g() returns (uint) { return L.f(); } }
+		contract B { A a = new A(); }
+	)";
+	boost::filesystem::path cacheDirectory =
+		boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("solc-cache-%%%%-%%%%-%%%%");
+	auto cache = make_shared<CompilationCache>(cacheDirectory.string());
+	auto compile = [&](CompilerStack& _compiler, string const& _source)
+	{
+		_compiler.addSource("", _source);
+		_compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		_compiler.setOptimiserSettings(dev::test::Options::get().optimize);
+		_compiler.setCompilationCache(cache, true);
+		_compiler.setRequestedOutputs(true, true);
+		BOOST_REQUIRE_MESSAGE(_compiler.compile(), "Compiling contract failed");
+	};
+
+	CompilerStack reference;
+	compile(reference, sourceCode);
+	CompilerStack cached;
+	compile(cached, sourceCode);
+	for (string name: {":L", ":A", ":B"})
+	{
+		// Loaded from the cache, so no code was generated.
+		BOOST_CHECK(!cached.assemblyItems(name));
+		BOOST_CHECK(cached.object(name).bytecode == reference.object(name).bytecode);
+		BOOST_CHECK(cached.object(name).linkReferences == reference.object(name).linkReferences);
+		BOOST_CHECK(cached.runtimeObject(name).bytecode == reference.runtimeObject(name).bytecode);
+		BOOST_CHECK(cached.cloneObject(name).bytecode == reference.cloneObject(name).bytecode);
+		BOOST_CHECK_EQUAL(cached.metadata(name), reference.metadata(name));
+		BOOST_CHECK_EQUAL(*cached.sourceMapping(name), *reference.sourceMapping(name));
+		BOOST_CHECK_EQUAL(*cached.runtimeSourceMapping(name), *reference.runtimeSourceMapping(name));
+		BOOST_CHECK(cached.gasEstimates(name) == reference.gasEstimates(name));
+	}
+
+	// Changing the optimizer settings invalidates all entries.
+	CompilerStack changedSettings;
+	changedSettings.addSource("", sourceCode);
+	changedSettings.setEVMVersion(dev::test::Options::get().evmVersion());
+	changedSettings.setOptimiserSettings(!dev::test::Options::get().optimize);
+	changedSettings.setCompilationCache(cache);
+	BOOST_REQUIRE(changedSettings.compile());
+	BOOST_CHECK(changedSettings.assemblyItems(":A"));
+
+	boost::filesystem::remove_all(cacheDirectory);
+}
+
+BOOST_AUTO_TEST_CASE(requested_outputs)
+{
+	char const* sourceCode = R"(
+		contract A { function f() returns (uint) { return 1; } }
+		contract B { A a = new A(); }
+	)";
+	auto compile = [&](bool _bytecode, bool _cloneObjects, CompilerStack& _compiler)
+	{
+		_compiler.addSource("", sourceCode);
+		_compiler.setEVMVersion(dev::test::Options::get().evmVersion());
+		_compiler.setRequestedOutputs(_bytecode, _cloneObjects);
+		BOOST_REQUIRE_MESSAGE(_compiler.compile(), "Compiling contract failed");
+	};
+	CompilerStack reference;
+	compile(true, true, reference);
+	BOOST_CHECK(reference.state() == CompilerStack::State::CompilationSuccessful);
+
+	CompilerStack analysisOnly;
+	compile(false, false, analysisOnly);
+	BOOST_CHECK(analysisOnly.state() == CompilerStack::State::AnalysisSuccessful);
+	for (string name: {":A", ":B"})
+	{
+		BOOST_CHECK_EQUAL(analysisOnly.metadata(name), reference.metadata(name));
+		BOOST_CHECK(analysisOnly.methodIdentifiers(name) == reference.methodIdentifiers(name));
+	}
+
+	// Clone objects are compiled on request.
+	CompilerStack lazyClones;
+	compile(true, false, lazyClones);
+	for (string name: {":A", ":B"})
+	{
+		BOOST_CHECK(lazyClones.object(name).bytecode == reference.object(name).bytecode);
+		BOOST_CHECK(!reference.cloneObject(name).bytecode.empty());
+		BOOST_CHECK(lazyClones.cloneObject(name).bytecode == reference.cloneObject(name).bytecode);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -23,6 +23,9 @@
 #include <libsolidity/parsing/Scanner.h>
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace dev
 {
 namespace solidity
@@ -393,6 +396,93 @@ BOOST_AUTO_TEST_CASE(invalid_hex_literal_nonhex_string)
 	BOOST_CHECK_EQUAL(scanner.next(), Token::Illegal);
 }
 
+BOOST_AUTO_TEST_CASE(shared_text)
+{
+	auto text = std::make_shared<std::string const>("contract\n  C {}");
+	CharStream stream(vector_ref<char const>(text->data(), text->size()), text);
+	Scanner scanner(stream);
+	// Neither the scanner nor copies of the stream copy the text.
+	BOOST_CHECK(scanner.source().data() == text->data());
+	BOOST_CHECK(CharStream(stream).source().data() == text->data());
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Contract);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), "C");
+	BOOST_CHECK_EQUAL(scanner.lineAtPosition(scanner.currentLocation().start), "  C {}");
+	BOOST_CHECK(scanner.translatePositionToLineColumn(scanner.currentLocation().start) == std::make_tuple(1, 2));
+}
+
+BOOST_AUTO_TEST_CASE(keywords)
+{
+	// All tokens whose string consists of lower case letters are keywords. "hex" has to be
+	// followed by a string literal.
+	for (unsigned i = 0; i < Token::NUM_TOKENS; ++i)
+	{
+		Token::Value token = Token::Value(i);
+		char const* name = Token::toString(token);
+		if (token != Token::Hex && name && std::all_of(name, name + strlen(name), [](char c) { return 'a' <= c && c <= 'z'; }))
+			BOOST_CHECK_EQUAL(Scanner(CharStream(name)).currentToken(), token);
+	}
+	BOOST_CHECK_EQUAL(Scanner(CharStream("contracts")).currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(Scanner(CharStream("contrac")).currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(Scanner(CharStream("Contract")).currentToken(), Token::Identifier);
+}
+
+BOOST_AUTO_TEST_CASE(sized_elementary_types)
+{
+	auto check = [](std::string const& _name, Token::Value _token, unsigned _first, unsigned _second)
+	{
+		Scanner scanner{CharStream(_name)};
+		BOOST_CHECK_MESSAGE(
+			scanner.currentToken() == _token && scanner.currentTokenInfo() == std::make_tuple(_first, _second),
+			_name
+		);
+	};
+	check("uint8", Token::UIntM, 8, 0);
+	check("int256", Token::IntM, 256, 0);
+	check("uint08", Token::UIntM, 8, 0);
+	check("bytes1", Token::BytesM, 1, 0);
+	check("bytes32", Token::BytesM, 32, 0);
+	check("fixed8x80", Token::FixedMxN, 8, 80);
+	check("ufixed256x0", Token::UFixedMxN, 256, 0);
+	check("uint0", Token::Identifier, 0, 0);
+	check("uint7", Token::Identifier, 0, 0);
+	check("uint264", Token::Identifier, 0, 0);
+	check("uint99999999999", Token::Identifier, 0, 0);
+	check("uint8x", Token::Identifier, 0, 0);
+	check("bytes0", Token::Identifier, 0, 0);
+	check("bytes33", Token::Identifier, 0, 0);
+	check("fixed8x81", Token::Identifier, 0, 0);
+	check("fixed8x", Token::Identifier, 0, 0);
+	check("fixed8x8x8", Token::Identifier, 0, 0);
+	check("fixed8", Token::Identifier, 0, 0);
+	check("string8", Token::Identifier, 0, 0);
+	check("x8", Token::Identifier, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(long_runs)
+{
+	// Runs that are longer than the blocks of characters the scanner looks at at once.
+	std::string identifier = "a_$0123456789bcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	std::string text = std::string(40, ' ') + "\t\r\n" + identifier + "+/* " + std::string(40, '*') + " */" +
+		"\"" + std::string(20, 'x') + "\\n" + std::string(20, '\xc3') + "\\\"" + "\"" +
+		"/** " + std::string(40, 'y') + "*\n * " + std::string(20, 'z') + "\n */" + "x" + std::string(40, '\n');
+	Scanner scanner(CharStream(std::move(text)));
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), identifier);
+	BOOST_CHECK_EQUAL(scanner.currentLocation().start, 43);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Add);
+	BOOST_CHECK_EQUAL(scanner.next(), Token::StringLiteral);
+	BOOST_CHECK_EQUAL(scanner.currentLiteral(), std::string(20, 'x') + "\n" + std::string(20, '\xc3') + "\"");
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.currentCommentLiteral(), std::string(40, 'y') + "*\n" + std::string(20, 'z'));
+	BOOST_CHECK_EQUAL(scanner.next(), Token::EOS);
+}
+
+BOOST_AUTO_TEST_CASE(long_unterminated_comment)
+{
+	Scanner scanner(CharStream("/* " + std::string(40, '*')));
+	BOOST_CHECK_EQUAL(scanner.currentToken(), Token::Illegal);
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 
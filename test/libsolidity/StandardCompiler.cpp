@@ -724,6 +724,56 @@ BOOST_AUTO_TEST_CASE(library_linking)
 	BOOST_CHECK(contract["evm"]["bytecode"]["linkReferences"]["library2.sol"]["L2"][0].isObject());
 }
 
+BOOST_AUTO_TEST_CASE(output_selection_restricts_code_generation)
+{
+	auto input = [](string const& _selection)
+	{
+		return R"(
+		{
+			"language": "Solidity",
+			"settings": {
+				"outputSelection": {
+					"fileA": )" + _selection + R"(
+				}
+			},
+			"sources": {
+				"fileA": {
+					"content": "contract A { function f() {} } contract B { function g() {} } contract C { function h() { new B(); } }"
+				}
+			}
+		}
+		)";
+	};
+	Json::Value full = compile(input(R"({ "*": [ "*" ] })"));
+	BOOST_CHECK(containsAtMostWarnings(full));
+	Json::Value result = compile(input(R"({
+		"A": [ "abi", "metadata", "evm.methodIdentifiers" ],
+		"C": [ "evm.bytecode.object" ]
+	})"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value contract = getContractResult(result, "fileA", "A");
+	BOOST_CHECK_EQUAL(dev::jsonCompactPrint(contract["abi"]), dev::jsonCompactPrint(getContractResult(full, "fileA", "A")["abi"]));
+	BOOST_CHECK_EQUAL(contract["metadata"].asString(), getContractResult(full, "fileA", "A")["metadata"].asString());
+	BOOST_CHECK_EQUAL(contract["evm"]["methodIdentifiers"]["f()"].asString(), "26121ff0");
+	BOOST_CHECK(!contract["evm"].isMember("bytecode"));
+	contract = getContractResult(result, "fileA", "C");
+	Json::Value fullContract = getContractResult(full, "fileA", "C");
+	BOOST_CHECK_EQUAL(contract["evm"]["bytecode"]["object"].asString(), fullContract["evm"]["bytecode"]["object"].asString());
+	BOOST_CHECK(!contract["evm"]["bytecode"].isMember("sourceMap"));
+	BOOST_CHECK(!fullContract["evm"]["bytecode"]["sourceMap"].asString().empty());
+
+	// Without any code artifacts, compilation stops after the analysis.
+	result = compile(input(R"({ "*": [ "abi", "metadata" ], "": [ "ast" ] })"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(result["sources"]["fileA"]["ast"].isObject());
+	for (string name: {"A", "B", "C"})
+	{
+		contract = getContractResult(result, "fileA", name);
+		BOOST_CHECK_EQUAL(contract["metadata"].asString(), getContractResult(full, "fileA", name)["metadata"].asString());
+		BOOST_CHECK(!contract["evm"].isMember("bytecode"));
+	}
+}
+
 BOOST_AUTO_TEST_CASE(evm_version)
 {
 	auto inputForVersion = [](string const& _version)
@@ -762,6 +812,47 @@ BOOST_AUTO_TEST_CASE(evm_version)
 	BOOST_CHECK(result["errors"][0]["message"].asString() == "Invalid EVM version requested.");
 }
 
+BOOST_AUTO_TEST_CASE(timings)
+{
+	auto input = [](string const& _timings)
+	{
+		return R"(
+			{
+				"language": "Solidity",
+				"sources": { "fileA": { "content": "contract A { function f(uint x) returns (uint) { return x * 2 + 1; } }" } },
+				"settings": {
+					)" + _timings + R"(
+					"optimizer": { "enabled": true },
+					"outputSelection": {
+						"fileA": {
+							"A": [ "evm.bytecode.object" ]
+						}
+					}
+				}
+			}
+		)";
+	};
+	Json::Value result = compile(input(""));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	BOOST_CHECK(!result.isMember("timings"));
+
+	result = compile(input("\"timings\": true,"));
+	BOOST_CHECK(containsAtMostWarnings(result));
+	Json::Value const& timings = result["timings"];
+	BOOST_REQUIRE(timings.isObject());
+	for (string phase: {"Scanning and parsing", "SyntaxChecker", "NameAndTypeResolver", "TypeChecker", "StaticAnalyzer"})
+	{
+		BOOST_REQUIRE_MESSAGE(timings["fileA"][phase].isObject(), phase);
+		BOOST_CHECK_EQUAL(timings["fileA"][phase]["count"].asUInt(), phase == "NameAndTypeResolver" ? 3 : 1);
+		BOOST_CHECK(timings["fileA"][phase]["seconds"].asDouble() >= 0);
+	}
+	BOOST_CHECK(timings[""]["ViewPureChecker"].isObject());
+	for (string phase: {"Code generation", "Assembling", "PeepholeOptimiser", "CommonSubexpressionEliminator", "ConstantOptimiser"})
+		BOOST_CHECK_MESSAGE(timings["fileA:A"][phase]["count"].asUInt() >= 1, phase);
+	// The fixed point iteration runs at least once for both the creation and the runtime code.
+	BOOST_CHECK(timings["fileA:A"]["Optimiser iteration"]["count"].asUInt() >= 2);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,314 @@
+/*
+	This file is part of solidity.
+
+	solidity is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	solidity is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with solidity.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * Benchmark of the compiler on the contracts in test/compilationTests.
+ */
+
+#include <libsolidity/interface/CompilerStack.h>
+#include <libsolidity/interface/Version.h>
+
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/JSON.h>
+#include <libdevcore/Timings.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+using namespace dev;
+using namespace dev::solidity;
+using namespace std;
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace
+{
+
+atomic<size_t> g_allocations{0};
+atomic<size_t> g_allocatedBytes{0};
+
+}
+
+// Counts all allocations of the process.
+void* operator new(size_t _size)
+{
+	++g_allocations;
+	g_allocatedBytes += _size;
+	if (void* memory = malloc(_size ? _size : 1))
+		return memory;
+	throw bad_alloc();
+}
+
+void operator delete(void* _memory) noexcept
+{
+	free(_memory);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void* _memory, size_t) noexcept
+{
+	free(_memory);
+}
+#endif
+
+namespace
+{
+
+/// The corpora in test/compilationTests.
+vector<string> const g_corpora{"zeppelin", "gnosis", "corion", "MultiSigWallet", "milestonetracker", "stringutils"};
+
+/// @returns all Solidity sources below @a _directory, named by their paths relative to it.
+map<string, string> loadSources(fs::path const& _directory)
+{
+	map<string, string> sources;
+	for (fs::recursive_directory_iterator it(_directory), end; it != end; ++it)
+		if (fs::is_regular_file(it->path()) && it->path().extension() == ".sol")
+		{
+			string name = it->path().generic_string().substr(_directory.generic_string().size() + 1);
+			sources[name] = readFileAsString(it->path().string());
+		}
+	return sources;
+}
+
+/// Compiles @a _sources @a _repetitions times and @returns the measurements of the fastest run
+/// together with the size and gas estimates of the generated code.
+Json::Value benchmark(map<string, string> const& _sources, bool _optimize, unsigned _repetitions)
+{
+	Json::Value result(Json::objectValue);
+	double fastest = numeric_limits<double>::max();
+	for (unsigned i = 0; i < _repetitions; ++i)
+	{
+		CompilerStack compiler;
+		for (auto const& source: _sources)
+			compiler.addSource(source.first, source.second);
+		compiler.setOptimiserSettings(_optimize);
+		compiler.useTimings(true);
+
+		size_t allocations = g_allocations;
+		size_t allocatedBytes = g_allocatedBytes;
+		auto start = chrono::steady_clock::now();
+		bool success = compiler.compile();
+		chrono::duration<double> duration = chrono::steady_clock::now() - start;
+		if (!success)
+		{
+			result["errors"] = Json::arrayValue;
+			for (auto const& error: compiler.errors())
+				if (error->type() != Error::Type::Warning)
+					result["errors"].append(boost::diagnostic_information(*error));
+			return result;
+		}
+		if (duration.count() >= fastest)
+			continue;
+		fastest = duration.count();
+
+		result["wallTime"] = duration.count();
+		result["allocations"] = Json::UInt64(g_allocations - allocations);
+		result["allocatedBytes"] = Json::UInt64(g_allocatedBytes - allocatedBytes);
+		map<string, double> phases;
+		for (auto const& unit: compiler.timings()->measurements())
+			for (auto const& phase: unit.second)
+				phases[phase.first] += phase.second.seconds;
+		result["phases"] = Json::objectValue;
+		for (auto const& phase: phases)
+			result["phases"][phase.first] = phase.second;
+
+		size_t bytecodeSize = 0;
+		result["contracts"] = Json::objectValue;
+		for (string const& name: compiler.contractNames())
+		{
+			Json::Value contract(Json::objectValue);
+			contract["bytecodeSize"] = Json::UInt64(compiler.object(name).bytecode.size());
+			contract["runtimeBytecodeSize"] = Json::UInt64(compiler.runtimeObject(name).bytecode.size());
+			bytecodeSize += compiler.object(name).bytecode.size();
+			Json::Value gasEstimates = compiler.gasEstimates(name);
+			if (gasEstimates.isObject())
+			{
+				contract["gas"] = Json::objectValue;
+				contract["gas"]["creation"] = gasEstimates["creation"]["totalCost"];
+				for (string const& function: gasEstimates["external"].getMemberNames())
+					contract["gas"][function] = gasEstimates["external"][function];
+			}
+			result["contracts"][name] = contract;
+		}
+		result["bytecodeSize"] = Json::UInt64(bytecodeSize);
+	}
+	return result;
+}
+
+/// @returns the relative change from @a _baseline to @a _value in percent.
+double relativeChange(double _baseline, double _value)
+{
+	return _baseline > 0 ? (_value - _baseline) / _baseline * 100 : 0;
+}
+
+/// Prints the differences between @a _results and @a _baseline.
+/// @returns the number of regressions, i.e. increases of the wall time or the number of allocations
+/// by more than @a _tolerance percent or of any bytecode size or finite gas estimate.
+size_t compare(Json::Value const& _baseline, Json::Value const& _results, double _tolerance)
+{
+	size_t regressions = 0;
+	cout << fixed << setprecision(1);
+	for (string const& corpus: _results["corpora"].getMemberNames())
+		for (string const& configuration: _results["corpora"][corpus].getMemberNames())
+		{
+			Json::Value const& result = _results["corpora"][corpus][configuration];
+			Json::Value const& base = _baseline["corpora"][corpus][configuration];
+			if (!base.isObject() || !base.isMember("wallTime") || !result.isMember("wallTime"))
+			{
+				cout << corpus << " (" << configuration << "): not comparable" << endl;
+				continue;
+			}
+			cout << corpus << " (" << configuration << "):" << endl;
+			auto report = [&](string const& _what, double _base, double _value, double _tolerance)
+			{
+				double change = relativeChange(_base, _value);
+				bool regression = _value > _base && change > _tolerance;
+				cout << "  " << _what << ": " << _base << " -> " << _value << " (" << showpos << change << noshowpos << "%)";
+				cout << (regression ? " REGRESSION" : "") << endl;
+				if (regression)
+					regressions++;
+			};
+			report("wall time [ms]", base["wallTime"].asDouble() * 1000, result["wallTime"].asDouble() * 1000, _tolerance);
+			report("allocations", base["allocations"].asDouble(), result["allocations"].asDouble(), _tolerance);
+			report("bytecode size", base["bytecodeSize"].asDouble(), result["bytecodeSize"].asDouble(), 0);
+			for (string const& contract: result["contracts"].getMemberNames())
+			{
+				Json::Value const& gas = result["contracts"][contract]["gas"];
+				Json::Value const& baseGas = base["contracts"][contract]["gas"];
+				for (string const& function: gas.getMemberNames())
+				{
+					string value = gas[function].asString();
+					string baseValue = baseGas[function].asString();
+					if (value == baseValue || value == "infinite" || baseValue == "infinite" || baseValue.empty())
+						continue;
+					report(
+						"gas of " + contract + (function == "creation" ? " creation" : "." + function),
+						boost::lexical_cast<double>(baseValue),
+						boost::lexical_cast<double>(value),
+						0
+					);
+				}
+			}
+		}
+	return regressions;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	fs::path testPath;
+	unsigned repetitions = 3;
+	double tolerance = 10;
+	po::options_description options(
+		R"(solbench, compiler benchmark.
+Usage: solbench [Options] [--testpath path]
+Compiles the contracts in test/compilationTests with and without optimiser
+and outputs the compilation time, the time spent in each compiler phase, the
+number of allocations, the bytecode sizes and gas estimates as JSON.
+
+Allowed options)",
+		po::options_description::m_default_line_length,
+		po::options_description::m_default_line_length - 23);
+	options.add_options()
+		("help", "Show this help screen.")
+		("testpath", po::value<fs::path>(&testPath), "path to test files")
+		("repetitions", po::value<unsigned>(&repetitions)->default_value(3), "number of compilations per corpus, the fastest one is reported")
+		("output", po::value<string>(), "file to write the results to instead of standard output")
+		("baseline", po::value<string>(), "results of a previous run to compare against, exits with an error on regressions")
+		("tolerance", po::value<double>(&tolerance)->default_value(10), "increase of the wall time and allocations in percent that is not a regression");
+
+	po::variables_map arguments;
+	try
+	{
+		po::command_line_parser cmdLineParser(argc, argv);
+		cmdLineParser.options(options);
+		po::store(cmdLineParser.run(), arguments);
+
+		if (arguments.count("help"))
+		{
+			cout << options << endl;
+			return 0;
+		}
+
+		po::notify(arguments);
+	}
+	catch (po::error const& _exception)
+	{
+		cerr << _exception.what() << endl;
+		return 1;
+	}
+
+	if (testPath.empty())
+		for (fs::path const& basePath: {fs::current_path() / ".." / ".." / "test", fs::current_path() / ".." / "test", fs::current_path() / "test"})
+			if (fs::is_directory(basePath / "compilationTests"))
+			{
+				testPath = basePath;
+				break;
+			}
+	if (!fs::is_directory(testPath / "compilationTests"))
+	{
+		cerr << "Test path not found. Use the --testpath option." << endl;
+		return 1;
+	}
+
+	Json::Value results(Json::objectValue);
+	results["version"] = VersionString;
+	results["corpora"] = Json::objectValue;
+	bool success = true;
+	for (string const& corpus: g_corpora)
+	{
+		map<string, string> sources = loadSources(testPath / "compilationTests" / corpus);
+		for (bool optimize: {false, true})
+		{
+			cerr << "Compiling " << corpus << (optimize ? " with" : " without") << " optimiser..." << endl;
+			Json::Value result = benchmark(sources, optimize, max(repetitions, 1u));
+			if (result.isMember("errors"))
+				success = false;
+			results["corpora"][corpus][optimize ? "optimized" : "unoptimized"] = move(result);
+		}
+	}
+
+	if (arguments.count("output"))
+		writeFile(arguments["output"].as<string>(), jsonPrettyPrint(results));
+	else if (!arguments.count("baseline"))
+		cout << jsonPrettyPrint(results) << endl;
+
+	if (arguments.count("baseline"))
+	{
+		Json::Value baseline;
+		if (!jsonParseStrict(readFileAsString(arguments["baseline"].as<string>()), baseline))
+		{
+			cerr << "Invalid baseline." << endl;
+			return 1;
+		}
+		size_t regressions = compare(baseline, results, tolerance);
+		cout << endl << regressions << " regression(s)." << endl;
+		if (regressions > 0)
+			success = false;
+	}
+
+	return success ? 0 : 1;
+}